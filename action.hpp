@@ -8,6 +8,7 @@ struct Action {
 
     int task_id = -1;
     int resource_id = -1;
+    double checkpoint_interval = -1;  // compute time between checkpoints, -1 to leave it to Scheduler::checkpoint_period
 };
 
 #endif
@@ -0,0 +1,25 @@
+#ifndef SIMULATOR_CHECKPOINT_HPP_
+#define SIMULATOR_CHECKPOINT_HPP_
+
+#include <cmath>
+
+// compute time between checkpoints which minimizes the expected waste of a task, for checkpoint cost c
+// and mean time between failures m of the resource
+namespace checkpoint {
+
+// first order, Young 1974
+inline double young_period(double c, double m) {
+    return std::sqrt(2 * c * m);
+}
+
+// higher order, Daly 2006
+inline double daly_period(double c, double m) {
+    if (c >= 2 * m)
+        return m;
+    double x = c / (2 * m);
+    return std::sqrt(2 * c * m) * (1 + std::sqrt(x) / 3 + x / 9) - c;
+}
+
+}  // namespace checkpoint
+
+#endif
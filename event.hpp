@@ -10,6 +10,11 @@ struct Event {
     const static int EVENT_RESOURCE_DOWN  = 5;
     const static int EVENT_RESOURCE_UP    = 6;
     const static int EVENT_RESOURCE_DELAY = 7;
+    const static int EVENT_RESOURCE_ADDED   = 8;
+    const static int EVENT_RESOURCE_REMOVED = 9;
+    const static int EVENT_SCHEDULER_DONE   = 10;  // scheduler decision takes effect, with decision latency only
+    const static int EVENT_SCHEDULER_WAKEUP = 11;  // asked for by the scheduler, resource_id is the one it gave
+    const static int EVENT_TASK_CANCELLED   = 12;  // another attempt of the task finished first, the slot is free
     static int ID;
 
     Event() : id(ID++) {}
@@ -27,6 +32,8 @@ struct Event {
     int slot;
     int id;
     double factor;
+    bool from_trace = false;  // start of an interval read from a streamed trace
+    bool from_model = false;  // sampled from the failure model of the resource
 };
 
 int Event::ID = 0;
@@ -0,0 +1,84 @@
+#ifndef SIMULATOR_EXECUTION_MODEL_HPP_
+#define SIMULATOR_EXECUTION_MODEL_HPP_
+
+#include <algorithm>
+#include <vector>
+
+#include "resource.hpp"
+#include "simd.hpp"
+#include "workflow.hpp"
+
+// execution speed of every task type on every resource, stored as one contiguous row of resources per task type
+// without workflow.type_speeds all tasks have one type and run with Resource::speed
+struct ExecutionModel {
+    void build(const Workflow &workflow, const std::vector<Resource> &resources) {
+        n = resources.size();
+        task_type.resize(workflow.tasks.size());
+        for (size_t i = 0; i < workflow.tasks.size(); ++i)
+            task_type[i] = workflow.type_speeds.empty() ? 0 : workflow.tasks[i].type;
+        types = workflow.type_speeds.empty() ? 1 : workflow.type_speeds.size();
+        typed = !workflow.type_speeds.empty();
+        stride = n;
+        speed.resize(types * stride);
+        for (int r = 0; r < n; ++r)
+            set_column(workflow, r, resources[r]);
+    }
+
+    // appends a resource with id n, rows are reallocated with doubled stride when full
+    void add_resource(const Workflow &workflow, const Resource &resource) {
+        if (n == stride) {
+            int new_stride = std::max(1, 2 * stride);
+            std::vector<double> new_speed(types * new_stride);
+            for (int t = 0; t < types; ++t)
+                std::copy(speed.begin() + t * stride, speed.begin() + t * stride + n, new_speed.begin() + t * new_stride);
+            speed.swap(new_speed);
+            stride = new_stride;
+        }
+        set_column(workflow, n++, resource);
+    }
+
+    void set_column(const Workflow &workflow, int r, const Resource &resource) {
+        for (int t = 0; t < types; ++t) {
+            if (workflow.type_speeds.empty())
+                speed[t * stride + r] = resource.speed;
+            else
+                speed[t * stride + r] = workflow.type_speeds[t][resource.type];
+        }
+    }
+
+    // time to run task with the given weight on resource
+    double time(int task, int res, double weight) const {
+        return weight / speed[task_type[task] * stride + res];
+    }
+
+    // out[r] = time to run task with the given weight on resource r, for all resources at once
+    void times(int task, double weight, double *out) const {
+        simd::div(weight, speed.data() + task_type[task] * stride, out, n);
+    }
+
+    // time of a unit of work in upward ranks, for every task type. with type_speeds it is the mean over
+    // resources, without them the sum of slots / speed that HEFT has always used
+    std::vector<double> rank_unit_times(const std::vector<Resource> &resources) const {
+        std::vector<double> unit(types, 0);
+        if (!typed) {
+            for (const auto &res : resources)
+                unit[0] += res.slots * 1. / res.speed;
+            return unit;
+        }
+        for (int t = 0; t < types; ++t) {
+            for (int r = 0; r < n; ++r)
+                unit[t] += 1 / speed[t * stride + r];
+            unit[t] /= std::max(1, n);
+        }
+        return unit;
+    }
+
+    int n = 0;
+    int types = 0;
+    bool typed = false;  // speeds come from workflow.type_speeds
+    int stride = 0;
+    std::vector<int> task_type;
+    std::vector<double> speed;  // speed[type * stride + res]
+};
+
+#endif
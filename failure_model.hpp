@@ -0,0 +1,47 @@
+#ifndef SIMULATOR_FAILURE_MODEL_HPP_
+#define SIMULATOR_FAILURE_MODEL_HPP_
+
+#include <cmath>
+#include <random>
+
+struct Distribution {
+    const static int DISTRIBUTION_FIXED       = 0;  // a
+    const static int DISTRIBUTION_EXPONENTIAL = 1;  // mean a
+    const static int DISTRIBUTION_WEIBULL     = 2;  // shape a, scale b
+    const static int DISTRIBUTION_LOGNORMAL   = 3;  // mu a, sigma b of the underlying normal
+
+    Distribution(int type = DISTRIBUTION_FIXED, double a = 0, double b = 0) : type(type), a(a), b(b) {}
+
+    template<typename Rng>
+    double sample(Rng &rng) const {
+        if (type == DISTRIBUTION_EXPONENTIAL)
+            return std::exponential_distribution<>{1 / a}(rng);
+        if (type == DISTRIBUTION_WEIBULL)
+            return std::weibull_distribution<>{a, b}(rng);
+        if (type == DISTRIBUTION_LOGNORMAL)
+            return std::lognormal_distribution<>{a, b}(rng);
+        return a;
+    }
+
+    double mean() const {
+        if (type == DISTRIBUTION_WEIBULL)
+            return b * std::tgamma(1 + 1 / a);
+        if (type == DISTRIBUTION_LOGNORMAL)
+            return std::exp(a + b * b / 2);
+        return a;
+    }
+
+    int type;
+    double a;
+    double b;
+};
+
+// availability of one resource: up for time_to_failure, then down for repair_time, and so on.
+// the next interval is sampled only when the previous one ends
+struct FailureModel {
+    Distribution time_to_failure;
+    Distribution repair_time;
+    bool enabled = false;
+};
+
+#endif
@@ -0,0 +1,220 @@
+#ifndef SIMULATOR_GAP_INDEX_HPP_
+#define SIMULATOR_GAP_INDEX_HPP_
+
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <vector>
+
+// timeline of one slot: non-overlapping allocations [start, end) ordered by start, kept in a treap
+// where every subtree knows the longest idle gap after its allocations.
+// earliest_start finds the first gap that fits a task in O(log n) instead of walking the allocations
+struct GapIndex {
+    // the timeline always starts with a fake allocation to avoid extra ifs
+    GapIndex(double start = -1, double end = 0) {
+        root = new_node(start, end);
+    }
+
+    // earliest start >= t of a task with duration d, the same as walking allocations
+    // from the last one starting before t until the task fits before the next one
+    double earliest_start(double t, double d) const {
+        int p = last_before(root, t, -1);
+        if (p == -1)
+            p = first(root);
+        const Node &pn = nodes[p];
+        if (pn.next_start == INF || std::max(t, pn.end) + d < pn.next_start)
+            return std::max(t, pn.end);
+        double key = pn.start;
+        while (true) {
+            // gaps are compared with a small slack and checked exactly, to get the same answer as the walk
+            int k = first_gap_after(root, key, d - EPS * std::max(1., std::abs(d)));
+            const Node &kn = nodes[k];
+            if (kn.next_start == INF || std::max(t, kn.end) + d < kn.next_start)
+                return std::max(t, kn.end);
+            key = kn.start;
+        }
+    }
+
+    void insert(double start, double end) {
+        int l, r;
+        split(root, start, end, l, r);
+        int v = new_node(start, end);
+        nodes[v].next_start = r == -1 ? INF : nodes[first(r)].start;
+        if (l != -1)
+            set_last_next(l, start);
+        pull(v);
+        root = merge(merge(l, v), r);
+    }
+
+    void erase(double start, double end) {
+        int l, m, r;
+        split(root, start, end, l, r);
+        split(r, start, end, m, r, false);
+        if (l != -1)
+            set_last_next(l, r == -1 ? INF : nodes[first(r)].start);
+        root = merge(l, r);
+        free_node(m);
+    }
+
+    // cheap lower bound of earliest_start(t, d): if no gap between allocations may fit the task, it goes after the last one
+    double lower_bound_start(double t, double d) const {
+        if (nodes[root].max_inner_gap > d - EPS * std::max(1., std::abs(d)))
+            return t;
+        return std::max(t, last_end());
+    }
+
+    double first_end() const {
+        return nodes[first(root)].end;
+    }
+
+    double last_end() const {
+        int v = root;
+        while (nodes[v].right != -1)
+            v = nodes[v].right;
+        return nodes[v].end;
+    }
+
+    // number of allocations, the fake one included
+    size_t size() const {
+        return nodes.size() - free_nodes.size();
+    }
+
+    struct Node {
+        double start;
+        double end;
+        double next_start;  // start of the next allocation, INF for the last one
+        double max_gap;     // max of next_start - end in the subtree
+        double max_inner_gap;  // the same without the infinite gap after the last allocation
+        unsigned priority;
+        int left = -1;
+        int right = -1;
+    };
+
+    constexpr static double INF = std::numeric_limits<double>::infinity();
+    constexpr static double EPS = 1e-7;
+
+    int new_node(double start, double end) {
+        Node node;
+        node.start = start;
+        node.end = end;
+        node.next_start = INF;
+        node.max_gap = INF;
+        node.max_inner_gap = -INF;
+        node.priority = rnd();
+        if (!free_nodes.empty()) {
+            int v = free_nodes.back();
+            free_nodes.pop_back();
+            nodes[v] = node;
+            return v;
+        }
+        nodes.push_back(node);
+        return nodes.size() - 1;
+    }
+
+    // erased nodes are reused by new_node
+    void free_node(int v) {
+        if (v == -1)
+            return;
+        free_node(nodes[v].left);
+        free_node(nodes[v].right);
+        free_nodes.push_back(v);
+    }
+
+    double gap(int v) const {
+        return v == -1 ? -INF : nodes[v].next_start - nodes[v].end;
+    }
+
+    double max_gap(int v) const {
+        return v == -1 ? -INF : nodes[v].max_gap;
+    }
+
+    double max_inner_gap(int v) const {
+        return v == -1 ? -INF : nodes[v].max_inner_gap;
+    }
+
+    void pull(int v) {
+        nodes[v].max_gap = std::max({gap(v), max_gap(nodes[v].left), max_gap(nodes[v].right)});
+        double inner_gap = nodes[v].next_start == INF ? -INF : gap(v);
+        nodes[v].max_inner_gap = std::max({inner_gap, max_inner_gap(nodes[v].left), max_inner_gap(nodes[v].right)});
+    }
+
+    // last allocation with start < t
+    int last_before(int v, double t, int best) const {
+        while (v != -1) {
+            if (nodes[v].start < t) {
+                best = v;
+                v = nodes[v].right;
+            } else {
+                v = nodes[v].left;
+            }
+        }
+        return best;
+    }
+
+    int first(int v) const {
+        while (nodes[v].left != -1)
+            v = nodes[v].left;
+        return v;
+    }
+
+    // first allocation with start > key whose gap is more than d
+    int first_gap_after(int v, double key, double d) const {
+        if (v == -1 || nodes[v].max_gap <= d)
+            return -1;
+        if (nodes[v].start > key) {
+            int res = first_gap_after(nodes[v].left, key, d);
+            if (res != -1)
+                return res;
+            if (gap(v) > d)
+                return v;
+        }
+        return first_gap_after(nodes[v].right, key, d);
+    }
+
+    void set_last_next(int v, double next_start) {
+        if (nodes[v].right == -1)
+            nodes[v].next_start = next_start;
+        else
+            set_last_next(nodes[v].right, next_start);
+        pull(v);
+    }
+
+    // l gets allocations less than (start, end), or not greater if !strict
+    void split(int v, double start, double end, int &l, int &r, bool strict = true) {
+        if (v == -1) {
+            l = r = -1;
+            return;
+        }
+        auto key = std::make_pair(nodes[v].start, nodes[v].end);
+        if (strict ? key < std::make_pair(start, end) : key <= std::make_pair(start, end)) {
+            split(nodes[v].right, start, end, nodes[v].right, r, strict);
+            l = v;
+        } else {
+            split(nodes[v].left, start, end, l, nodes[v].left, strict);
+            r = v;
+        }
+        pull(v);
+    }
+
+    int merge(int l, int r) {
+        if (l == -1)
+            return r;
+        if (r == -1)
+            return l;
+        if (nodes[l].priority > nodes[r].priority) {
+            nodes[l].right = merge(nodes[l].right, r);
+            pull(l);
+            return l;
+        }
+        nodes[r].left = merge(l, nodes[r].left);
+        pull(r);
+        return r;
+    }
+
+    std::vector<Node> nodes;
+    std::vector<int> free_nodes;
+    int root = -1;
+    std::minstd_rand rnd;
+};
+
+#endif
@@ -6,7 +6,12 @@
 #include "scheduler/scheduler.hpp"
 #include "scheduler/greedy_scheduler.hpp"
 #include "scheduler/heft_scheduler.hpp"
+#include "scheduler/genetic_scheduler.hpp"
 #include "scheduler/adaptive_scheduler.hpp"
+#include "scheduler/list_scheduler.hpp"
+#include "scheduler/batch_scheduler.hpp"
+#include "scheduler/work_stealing_scheduler.hpp"
+#include "scheduler/speculative_scheduler.hpp"
 
 #include <fstream>
 #include <iostream>
@@ -33,8 +38,33 @@ Simulator load(const std::string &scheduler,
         simulator.scheduler = std::shared_ptr<Scheduler>(new GreedyScheduler{});
     } else if (scheduler == "heft") {
         simulator.scheduler = std::shared_ptr<Scheduler>(new HeftScheduler{});
+    } else if (scheduler == "genetic") {
+        simulator.scheduler = std::shared_ptr<Scheduler>(new GeneticScheduler{});
     } else if (scheduler == "adaptive") {
         simulator.scheduler = std::shared_ptr<Scheduler>(new AdaptiveScheduler{});
+    } else if (scheduler == "peft") {
+        simulator.scheduler = std::shared_ptr<Scheduler>(new ListScheduler<list_policies::PeftPriority, list_policies::PeftPlacement>{});
+    } else if (scheduler == "cpop") {
+        simulator.scheduler = std::shared_ptr<Scheduler>(new ListScheduler<list_policies::CriticalPathPriority, list_policies::CpopPlacement>{});
+    } else if (scheduler == "dls") {
+        simulator.scheduler = std::shared_ptr<Scheduler>(new ListScheduler<list_policies::UpwardRankPriority, list_policies::DlsPlacement>{});
+    } else if (scheduler == "min_min") {
+        simulator.scheduler = std::shared_ptr<Scheduler>(new BatchScheduler<batch_heuristics::MinMin>{});
+    } else if (scheduler == "max_min") {
+        simulator.scheduler = std::shared_ptr<Scheduler>(new BatchScheduler<batch_heuristics::MaxMin>{});
+    } else if (scheduler == "sufferage") {
+        simulator.scheduler = std::shared_ptr<Scheduler>(new BatchScheduler<batch_heuristics::Sufferage>{});
+    } else if (scheduler == "work_stealing") {
+        simulator.scheduler = std::shared_ptr<Scheduler>(new WorkStealingScheduler{});
+    } else if (scheduler == "speculative") {
+        simulator.scheduler = std::shared_ptr<Scheduler>(new SpeculativeScheduler{});
+    } else if (scheduler.rfind("list-", 0) == 0) {
+        // list-<priority>-<placement>, e.g. list-upward_rank-insertion_eft
+        size_t dash = scheduler.find('-', 5);
+        if (dash != std::string::npos)
+            simulator.scheduler = make_list_scheduler(scheduler.substr(5, dash - 5), scheduler.substr(dash + 1));
+        if (!simulator.scheduler)
+            error("wrong scheduler");
     } else {
         error("wrong scheduler");
     }
@@ -61,8 +91,129 @@ Simulator load(const std::string &scheduler,
         simulator.settings.optimize_transfers = settings["optimize_transfers"].get<bool>();
         simulator.fail_prob = settings["task_fail_prob"].get<double>();
         simulator.logging = settings["logging"].get<bool>();
+        if (settings.contains("scheduler_stats"))
+            simulator.settings.scheduler_stats = settings["scheduler_stats"].get<bool>();
+        if (settings.contains("decision_latency"))
+            simulator.settings.decision_latency = settings["decision_latency"].get<double>();
+        if (settings.contains("latency_scale"))
+            simulator.settings.latency_scale = settings["latency_scale"].get<double>();
+        if (settings.contains("wall_clock_latency"))
+            simulator.settings.wall_clock_latency = settings["wall_clock_latency"].get<bool>();
+        if (settings.contains("steal_latency"))
+            simulator.settings.steal_latency = settings["steal_latency"].get<double>();
+        if (settings.contains("checkpoint_policy")) {
+            auto policy = settings["checkpoint_policy"].get<std::string>();
+            if (policy == "task") {
+                simulator.settings.checkpoint_policy = Settings::CHECKPOINT_TASK;
+            } else if (policy == "young") {
+                simulator.settings.checkpoint_policy = Settings::CHECKPOINT_YOUNG;
+            } else if (policy == "daly") {
+                simulator.settings.checkpoint_policy = Settings::CHECKPOINT_DALY;
+            } else {
+                error("wrong settings/checkpoint_policy " + policy);
+            }
+        }
+        if (settings.contains("provisioning_lag"))
+            simulator.settings.provisioning_lag = settings["provisioning_lag"].get<double>();
         if (settings.contains("profile") && scheduler == "adaptive")
             ((AdaptiveScheduler*)&*simulator.scheduler)->profile = settings["profile"].get<bool>();
+        if (settings.contains("incremental") && scheduler == "adaptive")
+            ((AdaptiveScheduler*)&*simulator.scheduler)->incremental = settings["incremental"].get<bool>();
+        if (settings.contains("background_planning") && scheduler == "adaptive")
+            ((AdaptiveScheduler*)&*simulator.scheduler)->background = settings["background_planning"].get<bool>();
+        if (settings.contains("replan_drift") && scheduler == "adaptive")
+            ((AdaptiveScheduler*)&*simulator.scheduler)->replan_drift = settings["replan_drift"].get<double>();
+        if (settings.contains("replan_policy") && scheduler == "adaptive") {
+            const auto &data = settings["replan_policy"];
+            auto param = [&](const std::string &param) {
+                if (!data.contains(param)) {
+                    error("need to specify settings/replan_policy/" + param);
+                }
+                return data[param];
+            };
+            auto type = param("type").get<std::string>();
+            ReplanPolicy policy;
+            if (type == "every_event") {
+                policy = ReplanPolicy(ReplanPolicy::POLICY_EVERY_EVENT);
+            } else if (type == "every_k") {
+                policy = ReplanPolicy(ReplanPolicy::POLICY_EVERY_K);
+                policy.k = param("k").get<int>();
+            } else if (type == "interval") {
+                policy = ReplanPolicy(ReplanPolicy::POLICY_INTERVAL);
+                policy.interval = param("interval").get<double>();
+            } else if (type == "deviation") {
+                policy = ReplanPolicy(ReplanPolicy::POLICY_DEVIATION);
+                policy.deviation = param("deviation").get<double>();
+            } else if (type == "failures") {
+                policy = ReplanPolicy(ReplanPolicy::POLICY_FAILURES);
+            } else {
+                error("wrong replan policy " + type);
+            }
+            ((AdaptiveScheduler*)&*simulator.scheduler)->replan_policy = policy;
+        }
+        if (settings.contains("local_search") && scheduler == "heft") {
+            const auto &data = settings["local_search"];
+            auto heft = (HeftScheduler*)&*simulator.scheduler;
+            if (!data.contains("moves")) {
+                error("need to specify settings/local_search/moves");
+            }
+            heft->local_search_moves = data["moves"].get<long long>();
+            if (data.contains("time_budget"))
+                heft->local_search_budget = data["time_budget"].get<double>();
+            if (data.contains("temperature"))
+                heft->local_search_temperature = data["temperature"].get<double>();
+        }
+        if (settings.contains("genetic") && scheduler == "genetic") {
+            const auto &data = settings["genetic"];
+            auto genetic = (GeneticScheduler*)&*simulator.scheduler;
+            if (data.contains("population"))
+                genetic->population_size = data["population"].get<int>();
+            if (data.contains("generations"))
+                genetic->generations = data["generations"].get<int>();
+            if (data.contains("time_budget"))
+                genetic->time_budget = data["time_budget"].get<double>();
+            if (data.contains("replicas"))
+                genetic->replicas = data["replicas"].get<int>();
+            if (data.contains("local_search"))
+                genetic->local_search = data["local_search"].get<int>();
+            if (genetic->population_size <= (int)genetic->elite)
+                error("settings/genetic/population must be more than " + std::to_string(genetic->elite));
+        }
+        if (settings.contains("speculative") && scheduler == "speculative") {
+            const auto &data = settings["speculative"];
+            auto speculative = (SpeculativeScheduler*)&*simulator.scheduler;
+            if (data.contains("slow_task_threshold"))
+                speculative->slow_task_threshold = data["slow_task_threshold"].get<double>();
+            if (data.contains("cap"))
+                speculative->speculative_cap = data["cap"].get<double>();
+        }
+        if (settings.contains("autoscaling") && (scheduler == "greedy" || scheduler == "heft" || scheduler == "adaptive")) {
+            const auto &data = settings["autoscaling"];
+            if (!data.contains("queue_threshold") || !data.contains("max_resources")) {
+                error("need to specify settings/autoscaling/queue_threshold and max_resources");
+            }
+            Autoscaler autoscaler;
+            autoscaler.queue = data["queue_threshold"].get<double>();
+            autoscaler.max = data["max_resources"].get<int>();
+            if (data.contains("idle_time"))
+                autoscaler.idle_time = data["idle_time"].get<double>();
+            if (scheduler == "greedy")
+                ((GreedyScheduler*)&*simulator.scheduler)->autoscaler = autoscaler;
+            else if (scheduler == "heft")
+                ((HeftScheduler*)&*simulator.scheduler)->autoscaler = autoscaler;
+            else
+                ((AdaptiveScheduler*)&*simulator.scheduler)->autoscaler = autoscaler;
+        }
+        if (settings.contains("fastest_first") && scheduler == "greedy")
+            ((GreedyScheduler*)&*simulator.scheduler)->fastest_first = settings["fastest_first"].get<bool>();
+        if (settings.contains("parallel_threshold") && scheduler == "heft")
+            ((HeftScheduler*)&*simulator.scheduler)->parallel_threshold = settings["parallel_threshold"].get<size_t>();
+        if (settings.contains("parallel_threshold") && scheduler == "adaptive")
+            ((AdaptiveScheduler*)&*simulator.scheduler)->parallel_threshold = settings["parallel_threshold"].get<size_t>();
+        if (settings.contains("resource_classes") && scheduler == "heft")
+            ((HeftScheduler*)&*simulator.scheduler)->use_resource_classes = settings["resource_classes"].get<bool>();
+        if (settings.contains("resource_classes") && scheduler == "adaptive")
+            ((AdaptiveScheduler*)&*simulator.scheduler)->use_resource_classes = settings["resource_classes"].get<bool>();
     }
 
     {
@@ -101,6 +252,36 @@ Simulator load(const std::string &scheduler,
             );
         }
 
+        if (workflow_data.contains("task_types")) {
+            if (!workflow_data.contains("type_speeds")) {
+                error("need to specify workflow/type_speeds together with workflow/task_types");
+            }
+            auto task_types = workflow_data["task_types"].get<std::vector<int>>();
+            if (task_types.size() != workflow.tasks.size()) {
+                error("size of workflow/task_types should be equal to size of workflow/tasks");
+            }
+            for (size_t i = 0; i < task_types.size(); ++i)
+                workflow.tasks[i].type = task_types[i];
+            workflow.type_speeds = workflow_data["type_speeds"].get<std::vector<std::vector<double>>>();
+        }
+
+        if (workflow_data.contains("checkpoint_intervals")) {
+            auto intervals = workflow_data["checkpoint_intervals"].get<std::vector<double>>();
+            if (intervals.size() != workflow.tasks.size()) {
+                error("size of workflow/checkpoint_intervals should be equal to size of workflow/tasks");
+            }
+            for (size_t i = 0; i < intervals.size(); ++i)
+                workflow.tasks[i].checkpoint_interval = intervals[i];
+        }
+        if (workflow_data.contains("checkpoint_costs")) {
+            auto costs = workflow_data["checkpoint_costs"].get<std::vector<double>>();
+            if (costs.size() != workflow.tasks.size()) {
+                error("size of workflow/checkpoint_costs should be equal to size of workflow/tasks");
+            }
+            for (size_t i = 0; i < costs.size(); ++i)
+                workflow.tasks[i].checkpoint_cost = costs[i];
+        }
+
         simulator.workflow = workflow;
     }
 
@@ -124,6 +305,8 @@ Simulator load(const std::string &scheduler,
                 resource["speed"].get<double>(),
                 resource["delay"].get<double>()
             ));
+            if (resource.contains("type"))
+                simulator.resources.back().type = resource["type"].get<int>();
         }
     }
 
@@ -151,6 +334,59 @@ Simulator load(const std::string &scheduler,
             }
         }
 
+        if (failures.contains("models")) {
+            auto load_distribution = [&](const json &data, const std::string &name) {
+                if (!data.contains("distribution")) {
+                    error("need to specify failures/models[i]/" + name + "/distribution");
+                }
+                auto param = [&](const std::string &param) {
+                    if (!data.contains(param)) {
+                        error("need to specify failures/models[i]/" + name + "/" + param);
+                    }
+                    return data[param].get<double>();
+                };
+                auto type = data["distribution"].get<std::string>();
+                if (type == "fixed")
+                    return Distribution(Distribution::DISTRIBUTION_FIXED, param("value"));
+                if (type == "exponential")
+                    return Distribution(Distribution::DISTRIBUTION_EXPONENTIAL, param("mean"));
+                if (type == "weibull")
+                    return Distribution(Distribution::DISTRIBUTION_WEIBULL, param("shape"), param("scale"));
+                if (type == "lognormal")
+                    return Distribution(Distribution::DISTRIBUTION_LOGNORMAL, param("mu"), param("sigma"));
+                error("wrong distribution " + type);
+                return Distribution();
+            };
+            for (auto model_data : failures["models"]) {
+                if (!model_data.contains("time_to_failure")) {
+                    error("need to specify failures/models[i]/time_to_failure");
+                }
+                if (!model_data.contains("repair_time")) {
+                    error("need to specify failures/models[i]/repair_time");
+                }
+                FailureModel model;
+                model.time_to_failure = load_distribution(model_data["time_to_failure"], "time_to_failure");
+                model.repair_time = load_distribution(model_data["repair_time"], "repair_time");
+                // without resource the model is used for every resource
+                if (model_data.contains("resource")) {
+                    simulator.set_failure_model(model_data["resource"].get<int>(), model);
+                } else {
+                    for (size_t i = 0; i < simulator.resources.size(); ++i)
+                        simulator.set_failure_model(i, model);
+                }
+            }
+            if (failures.contains("model_horizon"))
+                simulator.model_horizon = failures["model_horizon"].get<double>();
+        }
+
+        if (failures.contains("failure_trace")) {
+            simulator.failure_trace.open(failures["failure_trace"].get<std::string>(), false);
+        }
+
+        if (failures.contains("queue_trace")) {
+            simulator.queue_trace.open(failures["queue_trace"].get<std::string>(), true);
+        }
+
         if (failures.contains("stragglers")) {
             for (auto straggler : failures["stragglers"]) {
                 if (!straggler.contains("resource")) {
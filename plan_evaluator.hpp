@@ -0,0 +1,160 @@
+#ifndef SIMULATOR_PLAN_EVALUATOR_HPP_
+#define SIMULATOR_PLAN_EVALUATOR_HPP_
+
+#include <algorithm>
+#include <limits>
+#include <set>
+#include <vector>
+
+#include "execution_model.hpp"
+#include "resource.hpp"
+#include "settings.hpp"
+#include "workflow.hpp"
+
+// makespan of a static plan with expected durations and the timing of Simulator::make_action without failures:
+// a task is sent when its predecessors are done and the previous task of its slot has finished, loads input
+// not held by the resource, waits the expected queue delay and runs exec time * straggler factor.
+// one topological sweep over dependencies and slot order, all buffers are allocated in build,
+// so evaluate allocates nothing
+struct PlanEvaluator {
+    void build(const Workflow &workflow, const std::vector<Resource> &resources, const ExecutionModel &exec_model, const Settings &settings) {
+        this->exec_model = exec_model;
+        optimize_transfers = settings.optimize_transfers;
+        size_t n = workflow.tasks.size();
+        weight.resize(n);
+        pred_begin.assign(n + 1, 0);
+        succ_begin.assign(n + 1, 0);
+        for (size_t i = 0; i < n; ++i) {
+            weight[i] = workflow.tasks[i].weight;
+            pred_begin[i + 1] = pred_begin[i] + workflow.dependency_graph[i].size();
+            for (auto [pred, w] : workflow.dependency_graph[i])
+                ++succ_begin[pred + 1];
+        }
+        for (size_t i = 0; i < n; ++i)
+            succ_begin[i + 1] += succ_begin[i];
+        preds.resize(pred_begin[n]);
+        transfer.resize(pred_begin[n]);
+        succs.resize(succ_begin[n]);
+        std::vector<int> filled(succ_begin.begin(), succ_begin.end() - 1);
+        for (size_t i = 0; i < n; ++i) {
+            int k = pred_begin[i];
+            for (auto [pred, w] : workflow.dependency_graph[i]) {
+                preds[k] = pred;
+                transfer[k++] = w / settings.net_speed;
+                succs[filled[pred]++] = i;
+            }
+        }
+        delay.resize(resources.size());
+        delay_time.resize(resources.size());
+        straggler_factor.resize(resources.size());
+        for (size_t r = 0; r < resources.size(); ++r) {
+            delay[r] = resources[r].delay;
+            delay_time[r] = resources[r].delay * 0.55;
+            straggler_factor[r] = resources[r].straggler_factor;
+        }
+        task_res.resize(n);
+        prev.resize(n);
+        next.resize(n);
+        left.resize(n);
+        order.resize(n);
+        start.resize(n);
+        finish.resize(n);
+    }
+
+    // plan in the form of HeftScheduler::resource_schedules, tasks of every slot ordered by planned start.
+    // INF if some task is not in the plan
+    double evaluate(const std::vector<std::vector<std::set<std::pair<double, int>>>> &schedules) {
+        std::fill(task_res.begin(), task_res.end(), -1);
+        for (size_t res = 0; res < schedules.size(); ++res) {
+            for (const auto &schedule : schedules[res]) {
+                int last = -1;
+                for (auto [start, task] : schedule) {
+                    task_res[task] = res;
+                    prev[task] = last;
+                    last = task;
+                }
+            }
+        }
+        for (int res : task_res) {
+            if (res == -1)
+                return INF;
+        }
+        return evaluate(task_res.data(), prev.data());
+    }
+
+    // plan_res[task] runs the task, plan_prev[task] is the task before it on the same slot, -1 for the first one.
+    // INF if the slot order contradicts dependencies, the simulator would wait forever.
+    // with factors the sweep is one replica of the random run: exec time is multiplied by exec_factor[task]
+    // and the delay by delay_factor[task] instead of its mean 0.55
+    double evaluate(const int *plan_res, const int *plan_prev, const double *exec_factor = nullptr, const double *delay_factor = nullptr) {
+        int n = weight.size();
+        std::fill(next.begin(), next.end(), -1);
+        int head = 0, tail = 0;
+        for (int i = 0; i < n; ++i) {
+            left[i] = pred_begin[i + 1] - pred_begin[i] + (plan_prev[i] != -1);
+            if (plan_prev[i] != -1)
+                next[plan_prev[i]] = i;
+            if (left[i] == 0)
+                order[tail++] = i;
+        }
+        double makespan = 0;
+        while (head < tail) {
+            int task = order[head++];
+            settle(task, plan_res, plan_prev[task], exec_factor, delay_factor);
+            makespan = std::max(makespan, finish[task]);
+            for (int k = succ_begin[task]; k < succ_begin[task + 1]; ++k) {
+                if (--left[succs[k]] == 0)
+                    order[tail++] = succs[k];
+            }
+            if (next[task] != -1 && --left[next[task]] == 0)
+                order[tail++] = next[task];
+        }
+        return tail == n ? makespan : INF;
+    }
+
+    // start and finish of the task sent after its predecessors and prev_task (-1 if none) are done
+    double settle(int task, const int *plan_res, int prev_task, const double *exec_factor = nullptr, const double *delay_factor = nullptr) {
+        int r = plan_res[task];
+        double sent = prev_task == -1 ? 0 : finish[prev_task];
+        double load = 0;
+        for (int k = pred_begin[task]; k < pred_begin[task + 1]; ++k) {
+            sent = std::max(sent, finish[preds[k]]);
+            if (!optimize_transfers || plan_res[preds[k]] != r)
+                load = std::max(load, transfer[k]);
+        }
+        start[task] = sent;
+        double exec = exec_model.time(task, r, weight[task]) * straggler_factor[r];
+        if (exec_factor)
+            finish[task] = sent + load + delay[r] * delay_factor[task] + exec * exec_factor[task];
+        else
+            finish[task] = sent + load + delay_time[r] + exec;
+        return finish[task];
+    }
+
+    constexpr static double INF = std::numeric_limits<double>::infinity();
+
+    ExecutionModel exec_model;
+    bool optimize_transfers = false;
+    std::vector<double> weight;
+    std::vector<double> delay;
+    std::vector<double> delay_time;        // expected delay, delay * 0.55
+    std::vector<double> straggler_factor;
+
+    // dependencies in compressed rows: predecessors of task i are preds[pred_begin[i] .. pred_begin[i + 1])
+    std::vector<int> pred_begin;
+    std::vector<int> preds;
+    std::vector<double> transfer;          // transfer time of the data of every dependency
+    std::vector<int> succ_begin;
+    std::vector<int> succs;
+
+    // scratch of evaluate
+    std::vector<int> task_res;
+    std::vector<int> prev;
+    std::vector<int> next;
+    std::vector<int> left;
+    std::vector<int> order;
+    std::vector<double> start;             // time every task is sent, after evaluate
+    std::vector<double> finish;            // expected finish of every task after evaluate
+};
+
+#endif
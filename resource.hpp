@@ -27,9 +27,12 @@ struct Resource {
     int used_slots = 0;
     double speed;  // more -- faster
     bool is_up = true;
+    bool removed = false;  // released by the scheduler, never comes up again
     int id;
     double delay = 0;
     double straggler_factor = 1;
+    int type = 0;  // column of workflow.type_speeds
+    double mtbf = 0;  // mean time to failure of the failure model, 0 if unknown
     std::set<int> available_slots;
 };
 
@@ -0,0 +1,82 @@
+#ifndef SIMULATOR_RESOURCE_CLASSES_HPP_
+#define SIMULATOR_RESOURCE_CLASSES_HPP_
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <tuple>
+#include <vector>
+
+#include "resource.hpp"
+
+// groups resources with identical speed, delay, straggler factor and type,
+// keeps free times of all slots of every class ordered to pick one candidate per class
+struct ResourceClasses {
+    void build(const std::vector<Resource> &resources) {
+        class_by_params.clear();
+        resource_class.clear();
+        members.clear();
+        slot_end.clear();
+        free_slots.clear();
+        for (const auto &resource : resources)
+            add_resource(resource);
+    }
+
+    // appends a resource with the next id, its slots are not candidates until add_slot
+    void add_resource(const Resource &resource) {
+        auto key = std::make_tuple(resource.speed, resource.delay, resource.straggler_factor, resource.type);
+        if (!class_by_params.count(key)) {
+            class_by_params[key] = members.size();
+            members.emplace_back();
+            free_slots.emplace_back();
+        }
+        resource_class.push_back(class_by_params[key]);
+        members[resource_class.back()].push_back(resource_class.size() - 1);
+        slot_end.emplace_back(resource.slots, -1);
+    }
+
+    void clear() {
+        free_slots.assign(members.size(), {});
+        for (auto &v : slot_end)
+            std::fill(v.begin(), v.end(), -1);
+    }
+
+    size_t size() const {
+        return members.size();
+    }
+
+    // makes slot a candidate which is free starting from time
+    void add_slot(int res, int slot, double time) {
+        slot_end[res][slot] = time;
+        free_slots[resource_class[res]].emplace(time, res, slot);
+    }
+
+    // the slot is not a candidate anymore, until add_slot
+    void remove_slot(int res, int slot) {
+        free_slots[resource_class[res]].erase({slot_end[res][slot], res, slot});
+        slot_end[res][slot] = -1;
+    }
+
+    void set_slot_time(int res, int slot, double time) {
+        auto &s = free_slots[resource_class[res]];
+        s.erase({slot_end[res][slot], res, slot});
+        add_slot(res, slot, time);
+    }
+
+    // slot of the class which is free earliest, ignoring resources from skip (sorted); {-1, -1} if none
+    std::pair<int, int> earliest(int cls, const std::vector<int> &skip) const {
+        for (auto [time, res, slot] : free_slots[cls]) {
+            if (!std::binary_search(skip.begin(), skip.end(), res))
+                return {res, slot};
+        }
+        return {-1, -1};
+    }
+
+    std::map<std::tuple<double, double, double, int>, int> class_by_params;
+    std::vector<int> resource_class;
+    std::vector<std::vector<int>> members;
+    std::vector<std::set<std::tuple<double, int, int>>> free_slots;
+    std::vector<std::vector<double>> slot_end;
+};
+
+#endif
@@ -0,0 +1,96 @@
+#ifndef SIMULATOR_RESOURCE_INDEX_HPP_
+#define SIMULATOR_RESOURCE_INDEX_HPP_
+
+#include <algorithm>
+#include <vector>
+
+#include "resource.hpp"
+
+// segment tree over resources, answers "first/fastest up resource with a free slot" in O(log R)
+struct ResourceIndex {
+    void build(const std::vector<Resource> &resources) {
+        n = 1;
+        while (n < (int)resources.size())
+            n *= 2;
+        free_slots.assign(2 * n, 0);
+        fastest.assign(2 * n, -1);
+        speed.assign(n, 0);
+        for (int i = 0; i < (int)resources.size(); ++i) {
+            speed[i] = resources[i].speed;
+            set_leaf(i, resources[i]);
+        }
+        for (int v = n - 1; v >= 1; --v)
+            pull(v);
+    }
+
+    // call after any change of used_slots, slots, speed or is_up of a resource
+    void update(int res, const Resource &resource) {
+        if (res >= n) {
+            // resource added after build, grow the tree
+            std::vector<int> leaves_free(free_slots.begin() + n, free_slots.end());
+            std::vector<double> old_speed = speed;
+            int old_n = n;
+            while (n <= res)
+                n *= 2;
+            free_slots.assign(2 * n, 0);
+            fastest.assign(2 * n, -1);
+            speed.assign(n, 0);
+            for (int i = 0; i < old_n; ++i) {
+                speed[i] = old_speed[i];
+                free_slots[n + i] = leaves_free[i];
+                fastest[n + i] = leaves_free[i] > 0 ? i : -1;
+            }
+            for (int v = n - 1; v >= 1; --v)
+                pull(v);
+        }
+        speed[res] = resource.speed;
+        set_leaf(res, resource);
+        for (int v = (n + res) / 2; v >= 1; v /= 2)
+            pull(v);
+    }
+
+    // total number of free slots on up resources
+    int total_free() const {
+        return n == 0 ? 0 : free_slots[1];
+    }
+
+    // resource with minimal id that is up and has a free slot, -1 if none
+    int first_free() const {
+        if (total_free() == 0)
+            return -1;
+        int v = 1;
+        while (v < n)
+            v = free_slots[2 * v] > 0 ? 2 * v : 2 * v + 1;
+        return v - n;
+    }
+
+    // fastest up resource with a free slot (minimal id among equal speeds), -1 if none
+    int fastest_free() const {
+        return n == 0 ? -1 : fastest[1];
+    }
+
+    void set_leaf(int res, const Resource &resource) {
+        int f = resource.is_up ? std::max(0, resource.slots - resource.used_slots) : 0;
+        free_slots[n + res] = f;
+        fastest[n + res] = f > 0 ? res : -1;
+    }
+
+    void pull(int v) {
+        free_slots[v] = free_slots[2 * v] + free_slots[2 * v + 1];
+        int a = fastest[2 * v];
+        int b = fastest[2 * v + 1];
+        if (a == -1)
+            fastest[v] = b;
+        else if (b == -1)
+            fastest[v] = a;
+        else
+            fastest[v] = speed[b] > speed[a] ? b : a;
+    }
+
+    int n = 0;
+    std::vector<int> free_slots;
+    std::vector<int> fastest;
+    std::vector<double> speed;
+};
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef SIMULATOR_RESOURCE_VIEW_HPP_
+#define SIMULATOR_RESOURCE_VIEW_HPP_
+
+#include <limits>
+#include <vector>
+
+#include "resource.hpp"
+#include "simd.hpp"
+
+// structure-of-arrays copy of the resource data used by processor selection, so that
+// per-resource estimates for a task are computed by simd kernels instead of one Resource at a time.
+// speeds live in ExecutionModel rows
+struct ResourceView {
+    void build(const std::vector<Resource> &resources) {
+        delay_time.clear();
+        earliest_free.clear();
+        for (const auto &resource : resources)
+            add_resource(resource);
+    }
+
+    void add_resource(const Resource &resource) {
+        delay_time.push_back(resource.delay * 0.55);
+        earliest_free.push_back(INF);
+    }
+
+    int size() const {
+        return delay_time.size();
+    }
+
+    // out[r] = transfer_time + exec_time[r] + delay_time[r], expected duration of a task on every resource
+    void durations(double transfer_time, const double *exec_time, double *out) const {
+        simd::add(transfer_time, exec_time, delay_time.data(), out, size());
+    }
+
+    // min over resources of max(ready_time, earliest_free[r]): the task can start not later than that
+    // by going after the last allocation of the earliest free slot
+    double earliest_append_start(double ready_time) const {
+        return simd::min_of_max(ready_time, earliest_free.data(), size());
+    }
+
+    constexpr static double INF = std::numeric_limits<double>::infinity();
+
+    std::vector<double> delay_time;        // expected delay, delay * 0.55
+    std::vector<double> earliest_free;     // min over slots of the end of the last allocation, INF if resource is down
+};
+
+#endif
@@ -1,24 +1,38 @@
 #ifndef SIMULATOR_ADAPTIVE_SCHEDULER_HPP_
 #define SIMULATOR_ADAPTIVE_SCHEDULER_HPP_
 
+#include "autoscaler.hpp"
+#include "replan_policy.hpp"
 #include "scheduler.hpp"
+#include "slot_choice.hpp"
 #include "../action.hpp"
+#include "../gap_index.hpp"
+#include "../resource_classes.hpp"
+#include "../resource_view.hpp"
+#include "../thread_pool.hpp"
 #include "../workflow.hpp"
 
 #include <iostream>
 #include <algorithm>
+#include <chrono>
+#include <future>
 #include <map>
+#include <memory>
 
 struct AdaptiveScheduler: public Scheduler {
-    double get_task_res_time(int task, int resource) const {
+    double get_transfer_time(int task, int resource) const {
         double transfer_time = 0;
         for (auto [succ, w] : workflow.dependency_graph[task]) {
             assert(task_res[succ] != -1);
             if (settings.optimize_transfers && task_res[succ] == resource) continue;
             transfer_time = std::max(transfer_time, w / settings.net_speed);
         }
+        return transfer_time;
+    }
+
+    double get_task_res_time(int task, int resource) const {
         double task_time = std::max(1e-3, workflow.tasks[task].weight);
-        return transfer_time + task_time / resources[resource].speed + resources[resource].delay * 0.55;
+        return get_transfer_time(task, resource) + exec_model.time(task, resource, task_time) + resources[resource].delay * 0.55;
     }
 
     std::vector<Action> assign_available() {
@@ -37,6 +51,15 @@ struct AdaptiveScheduler: public Scheduler {
                         task_eft[task] = start + get_task_res_time(task, res);
                         slot_free_time[res][slot] = task_eft[task];
                         scheduled[task] = true;
+                        // the allocation follows the task to the time it is sent, a later end pushes
+                        // the next tasks of the slot now and re-places them at the next incremental replan
+                        if (placed[task]) {
+                            double end = current_time + alloc_end[task] - alloc_start[task];
+                            unplace_task(task);
+                            allocate(task, res, slot, current_time, end);
+                            if (push_queue(res, slot, end))
+                                pending_seeds.push_back(resource_schedules[res][slot].begin()->second);
+                        }
                     }
                 }
             }
@@ -133,6 +156,7 @@ struct AdaptiveScheduler: public Scheduler {
             resources[i].speed = 1;
             resources[i].delay = 0;
         }
+        workflow.type_speeds.clear();
 
         find_equivalency_classes();
     }
@@ -149,14 +173,7 @@ struct AdaptiveScheduler: public Scheduler {
     void init_ranks() {
         rank.assign(workflow.tasks.size(), -1);
 
-        double avg_resource_time = 0;
-        {
-            int cnt = 0;
-            for (auto res : resources) {
-                cnt += res.slots;
-                avg_resource_time += res.slots * 1. / res.speed;
-            }
-        }
+        auto unit_time = exec_model.rank_unit_times(resources);
 
         std::vector<std::vector<std::pair<int, int>>> inv_graph(workflow.tasks.size());
         for (int i = 0; i < workflow.tasks.size(); ++i) {
@@ -172,7 +189,7 @@ struct AdaptiveScheduler: public Scheduler {
                     dfs(succ);
                 rank[task] = std::max(rank[task], w / settings.net_speed + rank[succ]);
             }
-            rank[task] += std::max(1e-3, workflow.tasks[task].weight) * avg_resource_time;
+            rank[task] += std::max(1e-3, workflow.tasks[task].weight) * unit_time[exec_model.task_type[task]];
         };
         for (int i = 0; i < workflow.tasks.size(); ++i)
             if (rank[i] == -1)
@@ -186,15 +203,26 @@ struct AdaptiveScheduler: public Scheduler {
         task_est.resize(workflow.tasks.size());
         task_eft.resize(workflow.tasks.size());
         scheduled.assign(workflow.tasks.size(), false);
+        placed.assign(workflow.tasks.size(), false);
+        dirty.assign(workflow.tasks.size(), false);
+        alloc_start.assign(workflow.tasks.size(), 0);
+        alloc_end.assign(workflow.tasks.size(), 0);
 
         if (!profile)
             remove_profile();
+        exec_model.build(workflow, resources);
+        resource_view.build(resources);
+        exec_time.resize(resources.size());
+        duration.resize(resources.size());
 
         slot_free_time.resize(resources.size());
         for (size_t i = 0; i < slot_free_time.size(); ++i)
             slot_free_time[i].assign(resources[i].slots, 0);
 
         init_ranks();
+
+        if (use_resource_classes)
+            resource_classes.build(resources);
     }
 
     void run_heft() {
@@ -205,78 +233,333 @@ struct AdaptiveScheduler: public Scheduler {
         resource_schedules.clear();
         resource_schedules.resize(resources.size());
 
-        std::vector<std::vector<std::set<std::pair<double, double>>>> resource_allocations(resources.size());
+        resource_allocations.assign(resources.size(), {});
         for (size_t i = 0; i < resource_allocations.size(); ++i) {
-            resource_allocations[i].resize(resources[i].slots);  // fake task at time=0 to avoid extra ifs
+            resource_allocations[i].reserve(resources[i].slots);  // fake task at time=0 to avoid extra ifs
             for (size_t j = 0; j < resources[i].slots; ++j) {
-                resource_allocations[i][j].emplace(-1, slot_free_time[i][j]);
+                resource_allocations[i].emplace_back(-1, slot_free_time[i][j]);
             }
             resource_schedules[i].resize(resources[i].slots);
         }
+        for (size_t i = 0; i < resources.size(); ++i) {
+            resource_view.earliest_free[i] = ResourceView::INF;
+            if (!resources[i].is_up) continue;
+            for (size_t j = 0; j < resources[i].slots; ++j)
+                resource_view.earliest_free[i] = std::min(resource_view.earliest_free[i], slot_free_time[i][j]);
+        }
+        if (use_resource_classes) {
+            resource_classes.clear();
+            for (size_t i = 0; i < resources.size(); ++i) {
+                if (!resources[i].is_up) continue;
+                for (size_t j = 0; j < resources[i].slots; ++j)
+                    resource_classes.add_slot(i, j, slot_free_time[i][j]);
+            }
+        }
+
+        estimated_finish = 0;
+        placed.assign(workflow.tasks.size(), false);
+        while (!pq.empty()) {
+            auto [rank, task] = pq.top();
+            pq.pop();
+            if (scheduled[task] || completed[task]) continue;
+            place_task(task);
+        }
+        drift = 0;
+        ++full_replans;
+    }
 
-        std::vector<double> eft(workflow.tasks.size(), 0);
-        double estimated_finish = 0;
+    // re-places only the seed tasks and, while their finish estimates move, their successors.
+    // tasks are taken by rank, so every task is placed after its changed predecessors
+    void run_incremental(const std::vector<int> &seeds) {
+        std::priority_queue<std::pair<double, int>> pq;
+        for (int task : seeds) {
+            if (!dirty[task]) {
+                dirty[task] = true;
+                pq.emplace(rank[task], task);
+            }
+        }
         while (!pq.empty()) {
             auto [rank, task] = pq.top();
             pq.pop();
+            dirty[task] = false;
             if (scheduled[task] || completed[task]) continue;
-            double ready_time = current_time;
-            for (auto [succ, w] : workflow.dependency_graph[task]) {
-                ready_time = std::max(ready_time, task_eft[succ]);
+            double old_finish = placed[task] ? alloc_end[task] : -1;
+            auto &queue = resource_schedules[task_res[task]][task_slot[task]];
+            // tasks planned after it on the slot move too, so it can take back its own place
+            for (auto it = queue.upper_bound({task_est[task], task}); it != queue.end(); ++it) {
+                if (!dirty[it->second]) {
+                    dirty[it->second] = true;
+                    pq.emplace(this->rank[it->second], it->second);
+                }
+                unplace_task(it->second);
             }
-            int best_res = -1;
-            int best_slot = -1;
-            double best_est = -1;
-            for (int res = 0; res < resource_allocations.size(); ++res) {
-                if (!resources[res].is_up) continue;
-                for (int slot = 0; slot < resource_allocations[res].size(); ++slot) {
-                    double res_task_time = get_task_res_time(task, res);
-                    auto it = resource_allocations[res][slot].lower_bound({ready_time, -1.});
-                    assert(it != resource_allocations[res][slot].begin());  // we have fake task
-                    it = prev(it);
-                    while (next(it) != resource_allocations[res][slot].end() && std::max(ready_time, it->second) + res_task_time >= next(it)->first)
-                        ++it;
-                    double start_time = std::max(ready_time, it->second);
-                    if (best_est == -1 || best_est > start_time) {
-                        best_est = start_time;
-                        best_slot = slot;
-                        best_res = res;
-                    }
+            queue.erase({task_est[task], task});
+            unplace_task(task);
+            place_task(task);
+            ++tasks_replanned;
+            if (alloc_end[task] == old_finish) continue;
+            for (int succ : successors[task]) {
+                if (!dirty[succ]) {
+                    dirty[succ] = true;
+                    pq.emplace(this->rank[succ], succ);
                 }
             }
-            assert(best_res != -1);
-            double start_time = best_est;
-            double finish_time = start_time + get_task_res_time(task, best_res);
-            estimated_finish = std::max(estimated_finish, finish_time);
-            resource_allocations[best_res][best_slot].emplace(start_time, finish_time);
-            resource_schedules[best_res][best_slot].emplace(start_time, task);
-            task_slot[task] = best_slot;
-            task_res[task] = best_res;
-            task_est[task] = start_time;
-            task_eft[task] = finish_time;
         }
-        // std::cerr << "estimated finish: " << estimated_finish << std::endl;
+        ++incremental_replans;
+    }
+
+    // puts the task into the earliest slot of resource_allocations
+    void place_task(int task) {
+        double ready_time = current_time;
+        for (auto [succ, w] : workflow.dependency_graph[task]) {
+            ready_time = std::max(ready_time, task_eft[succ]);
+        }
+        exec_model.times(task, std::max(1e-3, workflow.tasks[task].weight), exec_time.data());
+        auto res_task_time = [&](int res) {
+            return get_transfer_time(task, res) + exec_time[res] + resource_view.delay_time[res];
+        };
+        // durations on all resources at once, then fix resources which already hold some predecessor data
+        resource_view.durations(get_transfer_time(task, -1), exec_time.data(), duration.data());
+        if (settings.optimize_transfers)
+            for (auto [succ, w] : workflow.dependency_graph[task])
+                duration[task_res[succ]] = res_task_time(task_res[succ]);
+
+        SlotChoice best;
+        best.upper_bound = resource_view.earliest_append_start(ready_time);
+        auto try_slot = [&](SlotChoice &best, int res, int slot) {
+            double res_task_time = duration[res];
+            // skip slots that can't start earlier than the best one (or as early, losing the tie)
+            if (best.dominates(resource_allocations[res][slot].lower_bound_start(ready_time, res_task_time), res, slot)) {
+                ++best.pruned;
+                return;
+            }
+            ++best.evaluated;
+            best.update(resource_allocations[res][slot].earliest_start(ready_time, res_task_time), res, slot);
+        };
+        auto try_resources = [&](SlotChoice &best, int begin, int end) {
+            for (int res = begin; res < end; ++res) {
+                if (!resources[res].is_up) continue;
+                for (int slot = 0; slot < resource_allocations[res].size(); ++slot)
+                    try_slot(best, res, slot);
+            }
+        };
+        if (!use_resource_classes && resources.size() >= parallel_threshold) {
+            if (!pool)
+                pool = std::make_shared<ThreadPool>();
+            std::vector<SlotChoice> worker_best(pool->size(), best);
+            pool->parallel_for(resources.size(), parallel_chunk, [&](int begin, int end, int worker) {
+                try_resources(worker_best[worker], begin, end);
+            });
+            for (const auto &choice : worker_best)
+                best.merge(choice);
+        } else if (!use_resource_classes) {
+            try_resources(best, 0, resources.size());
+        } else {
+            // resources holding predecessors have their own transfer time, check them separately
+            std::vector<int> local;
+            if (settings.optimize_transfers)
+                for (auto [succ, w] : workflow.dependency_graph[task])
+                    local.push_back(task_res[succ]);
+            std::sort(local.begin(), local.end());
+            local.erase(std::unique(local.begin(), local.end()), local.end());
+            for (int res : local) {
+                if (!resources[res].is_up) continue;
+                for (int slot = 0; slot < resource_allocations[res].size(); ++slot)
+                    try_slot(best, res, slot);
+            }
+            for (int cls = 0; cls < resource_classes.size(); ++cls) {
+                auto [res, slot] = resource_classes.earliest(cls, local);
+                if (res != -1)
+                    try_slot(best, res, slot);
+            }
+        }
+        candidates_evaluated += best.evaluated;
+        candidates_pruned += best.pruned;
+        int best_res = best.res;
+        int best_slot = best.slot;
+        assert(best_res != -1);
+        double start_time = best.est;
+        double finish_time = start_time + duration[best_res];
+        estimated_finish = std::max(estimated_finish, finish_time);
+        resource_schedules[best_res][best_slot].emplace(start_time, task);
+        task_slot[task] = best_slot;
+        task_res[task] = best_res;
+        task_est[task] = start_time;
+        task_eft[task] = finish_time;
+        allocate(task, best_res, best_slot, start_time, finish_time);
+    }
+
+    void allocate(int task, int res, int slot, double start, double end) {
+        resource_allocations[res][slot].insert(start, end);
+        alloc_start[task] = start;
+        alloc_end[task] = end;
+        placed[task] = true;
+        update_slot(res, slot);
+    }
+
+    // shifts allocations of the tasks queued on the slot so that none starts before end, in queue order.
+    // returns whether some task moved
+    bool push_queue(int res, int slot, double end) {
+        auto &queue = resource_schedules[res][slot];
+        std::vector<std::pair<int, double>> moved;  // task, its new start
+        for (auto [start, task] : queue) {
+            if (!placed[task])
+                continue;
+            if (alloc_start[task] >= end)
+                break;
+            moved.emplace_back(task, end);
+            end += alloc_end[task] - alloc_start[task];
+        }
+        for (auto [task, start] : moved)
+            unplace_task(task);
+        for (auto [task, start] : moved) {
+            double length = alloc_end[task] - alloc_start[task];
+            queue.erase({task_est[task], task});
+            task_est[task] = start;
+            task_eft[task] = start + length;
+            queue.emplace(task_est[task], task);
+            allocate(task, res, slot, start, start + length);
+        }
+        return !moved.empty();
+    }
+
+    // takes the task out of resource_allocations
+    void unplace_task(int task) {
+        if (!placed[task])
+            return;
+        placed[task] = false;
+        resource_allocations[task_res[task]][task_slot[task]].erase(alloc_start[task], alloc_end[task]);
+        update_slot(task_res[task], task_slot[task]);
+    }
+
+    // the task stopped running, an early end frees the rest of its time for the next placements
+    void release_allocation(int task) {
+        int res = task_res[task];
+        int slot = task_slot[task];
+        if (placed[task]) {
+            unplace_task(task);
+            return;
+        }
+        // sent before the last full replan, the task is in the fake allocation at the start of the slot
+        auto &allocations = resource_allocations[res][slot];
+        double end = allocations.first_end();
+        if (end > current_time) {
+            allocations.erase(-1, end);
+            allocations.insert(-1, current_time);
+            update_slot(res, slot);
+        }
+    }
+
+    // earliest free time of the resource and its class after allocations of the slot changed
+    void update_slot(int res, int slot) {
+        if (!resources[res].is_up)
+            return;
+        if (use_resource_classes)
+            resource_classes.set_slot_time(res, slot, resource_allocations[res][slot].last_end());
+        resource_view.earliest_free[res] = GapIndex::INF;
+        for (const auto &allocations : resource_allocations[res])
+            resource_view.earliest_free[res] = std::min(resource_view.earliest_free[res], allocations.last_end());
+    }
+
+
+    // incremental mode: the plan of a failed resource, running tasks included, moves to other resources
+    void resource_down_seeds(int res, std::vector<int> &seeds) {
+        resource_view.earliest_free[res] = GapIndex::INF;
+        for (int slot = 0; slot < resources[res].slots; ++slot) {
+            if (use_resource_classes)
+                resource_classes.remove_slot(res, slot);
+            for (auto [start, task] : resource_schedules[res][slot])
+                seeds.push_back(task);
+        }
+    }
+
+    // incremental mode: slots of the resource are free from now on, tasks still queued on it
+    // and ready tasks that wait are placed again to use them
+    void resource_up_seeds(int res, std::vector<int> &seeds) {
+        for (int slot = 0; slot < resources[res].slots; ++slot) {
+            for (auto [start, task] : resource_schedules[res][slot]) {
+                placed[task] = false;
+                seeds.push_back(task);
+            }
+            resource_allocations[res][slot] = GapIndex(-1, current_time);
+            update_slot(res, slot);
+        }
+        for (int task : ready)
+            if (!scheduled[task])
+                seeds.push_back(task);
+    }
+
+    // grows per-resource data up to resources.size() after new resources were requested
+    void add_resources() {
+        for (size_t i = slot_free_time.size(); i < resources.size(); ++i) {
+            tasks_on_res.emplace_back();
+            slot_free_time.emplace_back(resources[i].slots, 0);
+            resource_schedules.emplace_back(resources[i].slots);
+            resource_allocations.emplace_back(resources[i].slots, GapIndex(-1., 0.));
+            if (!profile) {
+                resources[i].speed = 1;
+                resources[i].delay = 0;
+            }
+            exec_model.add_resource(workflow, resources[i]);
+            resource_view.add_resource(resources[i]);
+            exec_time.push_back(0);
+            duration.push_back(0);
+            if (use_resource_classes)
+                resource_classes.add_resource(resources[i]);
+        }
     }
 
     std::vector<Action> init(const Settings &settings) override {
         this->settings = settings;
-        completed.assign(workflow.tasks.size(), false);
+        init_ready();
 
         init_heft();
         run_heft();
 
-        return assign_available();
+        autoscaler.init(*this);
+        return scale(assign_available());
+    }
+
+    // ready tasks not sent to any resource
+    std::vector<int> waiting() const {
+        std::vector<int> tasks;
+        for (int task : ready)
+            if (!scheduled[task])
+                tasks.push_back(task);
+        return tasks;
+    }
+
+    // lets the autoscaler request or release resources after the actions are chosen,
+    // new resources come with EVENT_RESOURCE_ADDED and are used by the next replan
+    std::vector<Action> scale(std::vector<Action> actions) {
+        autoscaler.step(*this, waiting(), current_time);
+        return actions;
     }
 
     std::vector<Action> notify(const Event &event) override {
         current_time = event.time;
+        add_resources();
+        autoscaler.notify(*this, event, current_time);
+        // tasks to re-place in incremental mode
+        std::vector<int> seeds;
+        bool full_replan = !incremental || !profile;
+        double deviation = 0;
         if (event.event_type == Event::EVENT_TASK_FINISHED) {
-            completed[event.task_id] = true;
+            int task = event.task_id;
+            drift += std::abs(current_time - task_eft[task]);
+            deviation = std::abs(current_time - task_eft[task]) / std::max(1e-9, task_eft[task] - task_est[task]);
+            if (current_time != task_eft[task]) {
+                seeds = successors[task];
+                auto &queue = resource_schedules[task_res[task]][task_slot[task]];
+                if (!queue.empty())
+                    seeds.push_back(queue.begin()->second);
+            }
+            complete_task(event.task_id);
+            release_allocation(task);
             resources[event.resource_id].used_slots--;
             resources[event.resource_id].return_slot(task_slot[event.task_id]);
             tasks_on_res[event.resource_id].erase(event.task_id);
             task_eft[event.task_id] = current_time;
-            int task = event.task_id;
             slot_free_time[task_res[task]][task_slot[task]] = current_time;
 
             if (!profile) {
@@ -294,26 +577,149 @@ struct AdaptiveScheduler: public Scheduler {
         } else if (event.event_type == Event::EVENT_TASK_FAILED) {
             resources[event.resource_id].used_slots--;
             int task = event.task_id;
+            release_allocation(task);
             resource_schedules[task_res[task]][task_slot[task]].emplace(task_est[task], task);
             resources[event.resource_id].return_slot(task_slot[task]);
             tasks_on_res[event.resource_id].erase(task);
             scheduled[task] = false;
             slot_free_time[task_res[task]][task_slot[task]] = current_time;
-        } else if (event.event_type == Event::EVENT_RESOURCE_DOWN) {
+            seeds.push_back(task);
+        } else if (event.event_type == Event::EVENT_RESOURCE_DOWN || event.event_type == Event::EVENT_RESOURCE_REMOVED) {
             resources[event.resource_id].is_up = false;
+            resources[event.resource_id].removed |= event.event_type == Event::EVENT_RESOURCE_REMOVED;
             for (int task : tasks_on_res[event.resource_id]) {
                 resource_schedules[task_res[task]][task_slot[task]].emplace(task_est[task], task);
                 scheduled[task] = false;
             }
             tasks_on_res[event.resource_id].clear();
+            if (!full_replan)
+                resource_down_seeds(event.resource_id, seeds);
         } else if (event.event_type == Event::EVENT_RESOURCE_UP) {
             resources[event.resource_id].is_up = true;
             resources[event.resource_id].used_slots = 0;
             resources[event.resource_id].fill_slots();
             slot_free_time[event.resource_id].assign(resources[event.resource_id].slots, current_time);
+            if (!full_replan)
+                resource_up_seeds(event.resource_id, seeds);
+        } else if (event.event_type == Event::EVENT_RESOURCE_ADDED) {
+            resources[event.resource_id].is_up = true;
+            slot_free_time[event.resource_id].assign(resources[event.resource_id].slots, current_time);
+            if (!full_replan)
+                resource_up_seeds(event.resource_id, seeds);
         }
-        run_heft();
-        return assign_available();
+        if (background)
+            return scale(notify_background(event, deviation));
+        // changes are collected until the policy asks for a replan
+        pending_seeds.insert(pending_seeds.end(), seeds.begin(), seeds.end());
+        pending_full_replan |= full_replan;
+        if (!replan_policy.should_replan(event, current_time, deviation))
+            return scale(assign_available());
+        // the plan drifted too far from what happens, incremental fixes are not enough
+        if (pending_full_replan || drift > replan_drift * estimated_finish)
+            run_heft();
+        else
+            run_incremental(pending_seeds);
+        pending_seeds.clear();
+        pending_full_replan = false;
+        replan_policy.replanned(current_time);
+        return scale(assign_available());
+    }
+
+    // full replans run on a copy of the scheduler in a worker thread, tasks are dispatched from the old plan meanwhile
+    std::vector<Action> notify_background(const Event &event, double deviation) {
+        if (event.event_type != Event::EVENT_TASK_FINISHED)
+            plan_invalidated = true;
+        collect_plan(false);
+        if (replan_policy.should_replan(event, current_time, deviation)) {
+            if (planning.valid())
+                replan_requested = true;
+            else
+                start_planning();
+            replan_policy.replanned(current_time);
+        }
+        auto actions = assign_available();
+        // with nothing running no event may come to adopt the plan, so wait for it
+        while (planning.valid() && actions.empty() && running_tasks() == 0) {
+            collect_plan(true);
+            actions = assign_available();
+        }
+        return actions;
+    }
+
+    void start_planning() {
+        if (!pool && !use_resource_classes && resources.size() >= parallel_threshold)
+            pool = std::make_shared<ThreadPool>();
+        planner = std::make_shared<AdaptiveScheduler>(*this);
+        planner->candidates_evaluated = 0;
+        planner->candidates_pruned = 0;
+        planner->full_replans = 0;
+        plan_invalidated = false;
+        replan_requested = false;
+        auto plan = planner;
+        planning = std::async(std::launch::async, [plan] { plan->run_heft(); }).share();
+    }
+
+    // adopts the finished background plan, unless a failure or a resource change made it stale.
+    // a stale plan is thrown away and planned again
+    void collect_plan(bool wait) {
+        if (!planning.valid())
+            return;
+        if (!wait && planning.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+            return;
+        planning.get();
+        planning = {};
+        if (!plan_invalidated && planner->resources.size() == resources.size()) {
+            adopt_plan(*planner);
+            ++plans_adopted;
+        } else {
+            replan_requested = true;
+            ++plans_discarded;
+        }
+        planner.reset();
+        if (replan_requested)
+            start_planning();
+    }
+
+    // tasks dispatched since the snapshot keep running where they are and leave the new queues
+    void adopt_plan(const AdaptiveScheduler &plan) {
+        resource_schedules = plan.resource_schedules;
+        for (int task = 0; task < workflow.tasks.size(); ++task) {
+            if (scheduled[task] || completed[task]) {
+                if (!plan.scheduled[task] && !plan.completed[task])
+                    resource_schedules[plan.task_res[task]][plan.task_slot[task]].erase({plan.task_est[task], task});
+                continue;
+            }
+            task_res[task] = plan.task_res[task];
+            task_slot[task] = plan.task_slot[task];
+            task_est[task] = plan.task_est[task];
+            task_eft[task] = plan.task_eft[task];
+        }
+        resource_allocations = plan.resource_allocations;
+        placed = plan.placed;
+        alloc_start = plan.alloc_start;
+        alloc_end = plan.alloc_end;
+        estimated_finish = plan.estimated_finish;
+        resource_view = plan.resource_view;
+        resource_classes = plan.resource_classes;
+        drift = 0;
+        candidates_evaluated += plan.candidates_evaluated;
+        candidates_pruned += plan.candidates_pruned;
+        full_replans += plan.full_replans;
+    }
+
+    int running_tasks() const {
+        int count = 0;
+        for (const auto &tasks : tasks_on_res)
+            count += tasks.size();
+        return count;
+    }
+
+    void print_stats() const override {
+        std::cerr << "candidates evaluated: " << candidates_evaluated << ", pruned: " << candidates_pruned << std::endl;
+        std::cerr << "full replans: " << full_replans << ", incremental replans: " << incremental_replans
+                  << ", tasks replanned incrementally: " << tasks_replanned << std::endl;
+        if (background)
+            std::cerr << "background plans adopted: " << plans_adopted << ", discarded: " << plans_discarded << std::endl;
     }
 
     ~AdaptiveScheduler() {}
@@ -328,14 +734,59 @@ struct AdaptiveScheduler: public Scheduler {
     std::vector<double> task_eft;
     std::vector<std::set<int>> tasks_on_res;
     std::vector<bool> scheduled;
+    std::vector<double> exec_time;
+    std::vector<double> duration;
     double current_time = 0;
 
+    // plan kept between events for incremental replanning
+    std::vector<std::vector<GapIndex>> resource_allocations;
+    std::vector<bool> placed;  // task has an allocation in resource_allocations
+    std::vector<bool> dirty;
+    std::vector<double> alloc_start;  // allocation of the task, moved to the time it is sent
+    std::vector<double> alloc_end;
+    double estimated_finish = 0;
+
+    // re-place only affected tasks, full replan when sum of |finish - estimated finish| since
+    // the last one exceeds replan_drift * estimated makespan
+    bool incremental = false;
+    double replan_drift = 0.1;
+    double drift = 0;
+    std::vector<int> pending_seeds;
+    bool pending_full_replan = false;
+    ReplanPolicy replan_policy;
+    Autoscaler autoscaler;
+    long long full_replans = 0;
+    long long incremental_replans = 0;
+    long long tasks_replanned = 0;
+
+    // replan in a worker thread on a snapshot of the scheduler
+    bool background = false;
+    std::shared_ptr<AdaptiveScheduler> planner;
+    std::shared_future<void> planning;
+    bool plan_invalidated = false;
+    bool replan_requested = false;
+    long long plans_adopted = 0;
+    long long plans_discarded = 0;
+
     bool profile = true;
     std::vector<double> avg_time_s;
     std::vector<double> avg_time_c;
     double total_avg_time_s = 0;
     double total_avg_time_c = 0;
     std::vector<int> task_class;
+
+    // evaluate one slot per class of identical resources instead of every slot
+    bool use_resource_classes = false;
+    ResourceClasses resource_classes;
+    ResourceView resource_view;
+
+    // processor selection is split over threads from this number of resources
+    size_t parallel_threshold = 1024;
+    int parallel_chunk = 64;
+    std::shared_ptr<ThreadPool> pool;
+
+    long long candidates_evaluated = 0;
+    long long candidates_pruned = 0;
 };
 
 #endif
@@ -0,0 +1,103 @@
+#ifndef SIMULATOR_AUTOSCALER_HPP_
+#define SIMULATOR_AUTOSCALER_HPP_
+
+#include "scheduler.hpp"
+#include "../event.hpp"
+#include "../resource.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <set>
+#include <vector>
+
+// queue length threshold autoscaling: a copy of an initial resource is requested while more than
+// queue ready tasks per slot of the pending requests wait, up to max extra resources. the copy is of the
+// initial resource with the least modelled time of the waiting tasks.
+// an extra resource left idle for idle_time with no task waiting is released
+struct Autoscaler {
+    bool enabled() const {
+        return queue > 0;
+    }
+
+    // resources known at init are the ones to copy, call at the end of init of the scheduler
+    void init(const Scheduler &scheduler) {
+        initial = scheduler.resources.size();
+    }
+
+    // keeps idle times and pending requests, call on every event before step
+    void notify(const Scheduler &scheduler, const Event &event, double current_time) {
+        idle_since.resize(scheduler.resources.size(), current_time);
+        wakeup_time.resize(scheduler.resources.size(), -1);
+        int res = event.resource_id;
+        if (event.event_type == Event::EVENT_TASK_FINISHED || event.event_type == Event::EVENT_TASK_FAILED
+            || event.event_type == Event::EVENT_RESOURCE_UP || event.event_type == Event::EVENT_RESOURCE_ADDED)
+            idle_since[res] = current_time;
+        if (event.event_type == Event::EVENT_RESOURCE_ADDED) {
+            scaled.insert(res);
+            pending_slots -= scheduler.resources[res].slots;
+        }
+    }
+
+    // waiting are the ready tasks not sent to any resource
+    void step(Scheduler &scheduler, const std::vector<int> &waiting, double current_time) {
+        if (!enabled())
+            return;
+        int count = waiting.size();
+        while (count > queue * (pending_slots + 1) && requested < max) {
+            Resource resource = scheduler.resources[choose_template(scheduler, waiting)];
+            resource.used_slots = 0;
+            resource.available_slots.clear();
+            resource.fill_slots();
+            scheduler.request_resource(resource);
+            pending_slots += resource.slots;
+            ++requested;
+        }
+        for (auto it = scaled.begin(); it != scaled.end();) {
+            int res = *it;
+            const auto &resource = scheduler.resources[res];
+            double release_time = idle_since[res] + idle_time;
+            if (count > 0 || resource.used_slots > 0 || !resource.is_up) {
+                ++it;
+            } else if (release_time <= current_time) {
+                scheduler.release_resource(res);
+                --requested;
+                it = scaled.erase(it);
+            } else {
+                if (wakeup_time[res] != release_time)
+                    scheduler.wake_up(release_time, res);
+                wakeup_time[res] = release_time;
+                ++it;
+            }
+        }
+    }
+
+    // initial resource with the least total exec time of the waiting tasks by the execution model,
+    // so type_speeds pick the resource type that suits the queue. minimal id among equal times
+    int choose_template(const Scheduler &scheduler, const std::vector<int> &waiting) const {
+        int best = 0;
+        double best_time = std::numeric_limits<double>::infinity();
+        for (int res = 0; res < initial; ++res) {
+            double time = 0;
+            for (int task : waiting)
+                time += scheduler.exec_model.time(task, res, std::max(1e-3, scheduler.workflow.tasks[task].weight));
+            if (time < best_time) {
+                best = res;
+                best_time = time;
+            }
+        }
+        return best;
+    }
+
+    double queue = 0;      // waiting ready tasks per slot that trigger a new resource, 0 is off
+    int max = 0;           // extra resources at most
+    double idle_time = 0;  // idle time before an extra resource is released
+
+    int initial = 0;           // resources at init, candidates to copy
+    int requested = 0;         // extra resources requested and not released
+    int pending_slots = 0;     // slots of requested resources not up yet
+    std::set<int> scaled;      // extra resources that are up or down, not released
+    std::vector<double> idle_since;
+    std::vector<double> wakeup_time;  // of the last wake-up asked for the resource
+};
+
+#endif
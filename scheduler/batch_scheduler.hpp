@@ -0,0 +1,292 @@
+#ifndef SIMULATOR_BATCH_SCHEDULER_HPP_
+#define SIMULATOR_BATCH_SCHEDULER_HPP_
+
+#include "scheduler.hpp"
+#include "../action.hpp"
+#include "../resource_view.hpp"
+#include "../workflow.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <set>
+#include <tuple>
+
+// which task of the batch is mapped next, the one with the smallest key.
+// best and second are the two smallest expected completion times of the task over resources
+namespace batch_heuristics {
+
+struct MinMin {
+    static double key(double best, double) {
+        return best;
+    }
+};
+
+struct MaxMin {
+    static double key(double best, double) {
+        return -best;
+    }
+};
+
+// the task which loses most if it doesn't get its best resource
+struct Sufferage {
+    static double key(double best, double second) {
+        return -(second - best);
+    }
+};
+
+}  // namespace batch_heuristics
+
+// dynamic batch mapping: on every event all ready tasks are mapped one by one in the heuristic order,
+// each to the resource with the earliest expected completion time (ECT = availability + duration).
+// tasks mapped to a free slot start now, the others wait for the next mapping.
+// durations of a task are computed once when it becomes ready, and the best and the second best ECT
+// of every task are kept between mappings: when the availability of a resource goes up only tasks
+// whose best or second best is that resource are recomputed, when it goes down every task checks
+// one value, so a mapping is far from O(tasks^2 * resources)
+template<typename Heuristic>
+struct BatchScheduler: public Scheduler {
+    constexpr static double INF = std::numeric_limits<double>::infinity();
+
+    std::vector<Action> init(const Settings &settings) override {
+        this->settings = settings;
+        init_ready();
+        scheduled.assign(workflow.tasks.size(), false);
+        in_batch.assign(workflow.tasks.size(), false);
+        task_res.assign(workflow.tasks.size(), -1);
+        task_slot.assign(workflow.tasks.size(), -1);
+        duration.assign(workflow.tasks.size(), {});
+        best.assign(workflow.tasks.size(), INF);
+        second.assign(workflow.tasks.size(), INF);
+        best_res.assign(workflow.tasks.size(), -1);
+        second_res.assign(workflow.tasks.size(), -1);
+        key.assign(workflow.tasks.size(), INF);
+        visited.assign(workflow.tasks.size(), 0);
+        exec_model.build(workflow, resources);
+        resource_view.build(resources);
+        exec_time.resize(resources.size());
+        busy.resize(resources.size());
+        slot_end.resize(resources.size());
+        for (size_t i = 0; i < resources.size(); ++i) {
+            busy[i].assign(resources[i].slots, false);
+            slot_end[i].assign(resources[i].slots, 0);
+        }
+        avail.assign(resources.size(), 0);
+        watchers.assign(resources.size(), {});
+        return map_batch();
+    }
+
+    double transfer_time(int task, int res) const {
+        double time = 0;
+        for (auto [pred, w] : workflow.dependency_graph[task]) {
+            if (settings.optimize_transfers && task_res[pred] == res) continue;
+            time = std::max(time, w / settings.net_speed);
+        }
+        return time;
+    }
+
+    // the slot of the resource free earliest and when it is free, INF if the resource is down.
+    // a task running longer than expected is still expected to end now, but a free slot is preferred
+    std::pair<int, double> earliest_slot(int res) const {
+        if (!resources[res].is_up)
+            return {-1, INF};
+        int best_slot = -1;
+        double time = INF;
+        for (size_t slot = 0; slot < busy[res].size(); ++slot) {
+            double end = busy[res][slot] ? std::max(current_time, slot_end[res][slot]) : current_time;
+            if (end < time || (end == time && !busy[res][slot] && busy[res][best_slot])) {
+                best_slot = slot;
+                time = end;
+            }
+        }
+        return {best_slot, time};
+    }
+
+    void set_key(int task) {
+        order.erase({key[task], task});
+        key[task] = best[task] == INF ? INF : Heuristic::key(best[task], second[task]);
+        order.emplace(key[task], task);
+    }
+
+    // best and second best ECT of the task over all resources
+    void recompute(int task) {
+        best[task] = second[task] = INF;
+        best_res[task] = second_res[task] = -1;
+        for (size_t res = 0; res < resources.size(); ++res) {
+            double ect = avail[res] + duration[task][res];
+            if (ect < best[task]) {
+                second[task] = best[task];
+                second_res[task] = best_res[task];
+                best[task] = ect;
+                best_res[task] = res;
+            } else if (ect < second[task]) {
+                second[task] = ect;
+                second_res[task] = res;
+            }
+        }
+        if (best_res[task] != -1)
+            watchers[best_res[task]].push_back(task);
+        if (second_res[task] != -1)
+            watchers[second_res[task]].push_back(task);
+        set_key(task);
+    }
+
+    void set_avail(int res, double time) {
+        double old = avail[res];
+        avail[res] = time;
+        if (time > old) {
+            // a task may be in the list several times, it is recomputed once
+            std::vector<int> tasks;
+            tasks.swap(watchers[res]);
+            ++visits;
+            for (int task : tasks) {
+                if (in_batch[task] && visited[task] != visits && (best_res[task] == res || second_res[task] == res)) {
+                    visited[task] = visits;
+                    recompute(task);
+                }
+            }
+        } else if (time < old) {
+            for (int task : batch) {
+                double ect = time + duration[task][res];
+                if (best_res[task] == res) {
+                    best[task] = ect;
+                } else if (ect < best[task]) {
+                    second[task] = best[task];
+                    second_res[task] = best_res[task];
+                    best[task] = ect;
+                    best_res[task] = res;
+                    watchers[res].push_back(task);
+                } else if (second_res[task] == res) {
+                    second[task] = ect;
+                } else if (ect < second[task]) {
+                    second[task] = ect;
+                    second_res[task] = res;
+                    watchers[res].push_back(task);
+                } else {
+                    continue;
+                }
+                set_key(task);
+            }
+        }
+    }
+
+    void add_to_batch(int task) {
+        in_batch[task] = true;
+        batch.insert(task);
+        exec_model.times(task, std::max(1e-3, workflow.tasks[task].weight), exec_time.data());
+        duration[task].resize(resources.size());
+        resource_view.durations(transfer_time(task, -1), exec_time.data(), duration[task].data());
+        if (settings.optimize_transfers)
+            for (auto [pred, w] : workflow.dependency_graph[task])
+                duration[task][task_res[pred]] = transfer_time(task, task_res[pred]) + exec_time[task_res[pred]] + resource_view.delay_time[task_res[pred]];
+        recompute(task);
+    }
+
+    std::vector<Action> map_batch() {
+        for (size_t res = 0; res < resources.size(); ++res)
+            set_avail(res, earliest_slot(res).second);
+        for (int task : ready) {
+            if (!scheduled[task] && !in_batch[task])
+                add_to_batch(task);
+        }
+
+        std::vector<Action> actions;
+        // tasks mapped after running ones leave the batch till the end of the mapping,
+        // the slot keeps the expected end of its running task, set back after the mapping
+        std::vector<std::tuple<int, int, int, double>> reserved;
+        while (!order.empty() && order.begin()->first != INF) {
+            int task = order.begin()->second;
+            int res = best_res[task];
+            auto [slot, time] = earliest_slot(res);
+            in_batch[task] = false;
+            batch.erase(task);
+            order.erase({key[task], task});
+            if (busy[res][slot]) {
+                reserved.emplace_back(task, res, slot, slot_end[res][slot]);
+            } else {
+                std::vector<double>().swap(duration[task]);
+                busy[res][slot] = true;
+                scheduled[task] = true;
+                task_res[task] = res;
+                task_slot[task] = slot;
+                ++resources[res].used_slots;
+                actions.emplace_back(task, res);
+            }
+            slot_end[res][slot] = best[task];
+            set_avail(res, earliest_slot(res).second);
+        }
+        for (auto it = reserved.rbegin(); it != reserved.rend(); ++it) {
+            auto [task, res, slot, end] = *it;
+            slot_end[res][slot] = end;
+        }
+        for (auto [task, res, slot, end] : reserved)
+            set_avail(res, earliest_slot(res).second);
+        for (auto [task, res, slot, end] : reserved) {
+            in_batch[task] = true;
+            batch.insert(task);
+            recompute(task);
+        }
+        return actions;
+    }
+
+    // a task stops occupying its slot
+    void free_slot(int task) {
+        busy[task_res[task]][task_slot[task]] = false;
+        slot_end[task_res[task]][task_slot[task]] = current_time;
+    }
+
+    std::vector<Action> notify(const Event &event) override {
+        current_time = event.time;
+        if (event.event_type == Event::EVENT_TASK_FINISHED) {
+            complete_task(event.task_id);
+            --resources[event.resource_id].used_slots;
+            free_slot(event.task_id);
+        } else if (event.event_type == Event::EVENT_TASK_FAILED) {
+            --resources[event.resource_id].used_slots;
+            free_slot(event.task_id);
+            scheduled[event.task_id] = false;
+        } else if (event.event_type == Event::EVENT_RESOURCE_DOWN || event.event_type == Event::EVENT_RESOURCE_REMOVED) {
+            resources[event.resource_id].is_up = false;
+            resources[event.resource_id].removed |= event.event_type == Event::EVENT_RESOURCE_REMOVED;
+            for (size_t task = 0; task < workflow.tasks.size(); ++task) {
+                if (scheduled[task] && !completed[task] && task_res[task] == event.resource_id) {
+                    free_slot(task);
+                    scheduled[task] = false;
+                }
+            }
+        } else if (event.event_type == Event::EVENT_RESOURCE_UP || event.event_type == Event::EVENT_RESOURCE_ADDED) {
+            resources[event.resource_id].is_up = true;
+            resources[event.resource_id].used_slots = 0;
+        }
+        return map_batch();
+    }
+
+    ~BatchScheduler() {}
+
+    Settings settings;
+    std::vector<bool> scheduled;
+    std::vector<int> task_res;
+    std::vector<int> task_slot;
+    double current_time = 0;
+
+    ResourceView resource_view;
+    std::vector<double> exec_time;
+    std::vector<std::vector<bool>> busy;
+    std::vector<std::vector<double>> slot_end;  // expected end of the task on a busy slot
+
+    // ready tasks which are not running
+    std::set<int> batch;
+    std::vector<bool> in_batch;
+    std::vector<std::vector<double>> duration;  // duration[task][res], kept while the task is in the batch
+    std::vector<double> avail;                  // earliest time a slot of the resource is free
+    std::vector<double> best;
+    std::vector<double> second;
+    std::vector<int> best_res;
+    std::vector<int> second_res;
+    std::vector<double> key;
+    std::set<std::pair<double, int>> order;     // batch by heuristic key
+    std::vector<std::vector<int>> watchers;     // tasks which had the resource as best or second best
+    std::vector<long long> visited;
+    long long visits = 0;
+};
+
+#endif
@@ -0,0 +1,240 @@
+#ifndef SIMULATOR_GENETIC_SCHEDULER_HPP_
+#define SIMULATOR_GENETIC_SCHEDULER_HPP_
+
+#include "heft_scheduler.hpp"
+#include "../plan_evaluator.hpp"
+#include "../thread_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <random>
+
+// HEFT plan improved by a memetic algorithm before the first task is sent, then executed as HEFT does.
+// an individual is a slot for every task and a topological order, tasks of a slot run in that order.
+// the population starts from the HEFT plan and its mutations, fitness is the makespan by PlanEvaluator,
+// averaged with replicas sweeps of random durations if replicas > 0. offspring are scored in parallel,
+// every worker has its own evaluator and buffers. after every generation the best individual
+// goes through a short hill climb over slot changes. evolution stops after generations or time_budget
+// seconds of wall time
+struct GeneticScheduler: public HeftScheduler {
+    struct Individual {
+        std::vector<int> slot;   // global slot id of every task
+        std::vector<int> order;  // topological
+        double fitness = 0;
+    };
+
+    // scratch of one worker
+    struct Arena {
+        PlanEvaluator evaluator;
+        std::vector<int> res;
+        std::vector<int> prev;
+        std::vector<int> last;  // last task of every slot while decoding
+        std::vector<double> exec_factor;
+        std::vector<double> delay_factor;
+        std::minstd_rand rnd;
+    };
+
+    std::vector<Action> init(const Settings &settings) override {
+        auto start_time = std::chrono::steady_clock::now();
+        plan(settings);
+        size_t n = workflow.tasks.size();
+        slot_base.assign(resources.size() + 1, 0);
+        for (size_t res = 0; res < resources.size(); ++res)
+            slot_base[res + 1] = slot_base[res] + resources[res].slots;
+        slot_res.resize(slot_base.back());
+        for (size_t res = 0; res < resources.size(); ++res)
+            std::fill(slot_res.begin() + slot_base[res], slot_res.begin() + slot_base[res + 1], res);
+
+        if (!pool)
+            pool = std::make_shared<ThreadPool>();
+        arenas.resize(pool->size());
+        for (auto &arena : arenas) {
+            arena.evaluator.build(workflow, resources, exec_model, settings);
+            arena.res.resize(n);
+            arena.prev.resize(n);
+            arena.last.resize(slot_res.size());
+            arena.exec_factor.resize(n);
+            arena.delay_factor.resize(n);
+        }
+
+        Individual seed;
+        seed.slot.resize(n);
+        for (size_t task = 0; task < n; ++task)
+            seed.slot[task] = slot_base[task_res[task]] + task_slot[task];
+        seed.order = planned_order();
+        seed.fitness = fitness(seed, arenas[0]);
+        heft_fitness = seed.fitness;
+
+        std::vector<Individual> population(population_size, seed);
+        for (size_t i = 1; i < population.size(); ++i) {
+            for (int k = 0; k <= (int)(i % 8); ++k)
+                mutate(population[i]);
+        }
+        evaluate(population, 1);
+
+        auto out_of_time = [&] {
+            return std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count() >= time_budget;
+        };
+        std::vector<Individual> offspring(population_size);
+        std::vector<bool> in_prefix(n);
+        for (generations_done = 0; generations_done < generations && !out_of_time(); ++generations_done) {
+            // the best two survive, the rest is replaced by children of tournament winners
+            for (size_t i = elite; i < offspring.size(); ++i) {
+                const auto &a = tournament(population);
+                const auto &b = tournament(population);
+                crossover(a, b, offspring[i], in_prefix);
+                mutate(offspring[i]);
+            }
+            evaluate(offspring, elite);
+            for (size_t i = elite; i < offspring.size(); ++i)
+                std::swap(population[i], offspring[i]);
+            std::sort(population.begin(), population.end(), [](const Individual &a, const Individual &b) {
+                return a.fitness < b.fitness;
+            });
+            hill_climb(population[0]);
+        }
+
+        // the best plan replaces the HEFT one, slots keep tasks by the time they are sent
+        const Individual &best = population[0];
+        best_fitness = best.fitness;
+        if (best_fitness < heft_fitness) {
+            Arena &arena = arenas[0];
+            decode(best, arena);
+            arena.evaluator.evaluate(arena.res.data(), arena.prev.data());
+            set_plan(slot_base, best.slot, arena.evaluator.start);
+        }
+        return assign_available();
+    }
+
+    void decode(const Individual &ind, Arena &arena) const {
+        std::fill(arena.last.begin(), arena.last.end(), -1);
+        for (int task : ind.order) {
+            arena.res[task] = slot_res[ind.slot[task]];
+            arena.prev[task] = arena.last[ind.slot[task]];
+            arena.last[ind.slot[task]] = task;
+        }
+    }
+
+    // replicas use the same random durations for every individual, so that they are compared on equal terms
+    double fitness(const Individual &ind, Arena &arena) {
+        decode(ind, arena);
+        double sum = arena.evaluator.evaluate(arena.res.data(), arena.prev.data());
+        if (replicas > 0) {
+            arena.rnd.seed(1);
+            std::normal_distribution<> nd{1, 0.1};
+            std::uniform_real_distribution<> ud{0.0, 1.1};
+            for (int k = 0; k < replicas; ++k) {
+                for (size_t task = 0; task < arena.exec_factor.size(); ++task) {
+                    arena.exec_factor[task] = nd(arena.rnd);
+                    arena.delay_factor[task] = ud(arena.rnd);
+                }
+                sum += arena.evaluator.evaluate(arena.res.data(), arena.prev.data(), arena.exec_factor.data(), arena.delay_factor.data());
+            }
+        }
+        return sum / (1 + replicas);
+    }
+
+    // fitness of individuals from the given one on, in parallel
+    void evaluate(std::vector<Individual> &individuals, size_t from) {
+        pool->parallel_for(individuals.size() - from, 1, [&](int begin, int end, int worker) {
+            for (int i = begin; i < end; ++i) {
+                individuals[from + i].fitness = fitness(individuals[from + i], arenas[worker]);
+                ++evaluations;
+            }
+        });
+    }
+
+    const Individual &tournament(const std::vector<Individual> &population) {
+        const auto &a = population[rnd() % population.size()];
+        const auto &b = population[rnd() % population.size()];
+        return a.fitness <= b.fitness ? a : b;
+    }
+
+    // slots are taken from either parent, the order is a prefix of a and the other tasks in the order of b
+    void crossover(const Individual &a, const Individual &b, Individual &child, std::vector<bool> &in_prefix) {
+        size_t n = a.slot.size();
+        child.slot.resize(n);
+        child.order.resize(n);
+        for (size_t task = 0; task < n; ++task)
+            child.slot[task] = rnd() % 2 ? a.slot[task] : b.slot[task];
+        size_t cut = rnd() % (n + 1);
+        std::fill(in_prefix.begin(), in_prefix.end(), false);
+        for (size_t i = 0; i < cut; ++i) {
+            child.order[i] = a.order[i];
+            in_prefix[a.order[i]] = true;
+        }
+        size_t k = cut;
+        for (int task : b.order) {
+            if (!in_prefix[task])
+                child.order[k++] = task;
+        }
+    }
+
+    // a task goes to a random slot, or to a random place of the order between its predecessors and successors
+    void mutate(Individual &ind) {
+        size_t n = ind.slot.size();
+        int task = rnd() % n;
+        if (rnd() % 2) {
+            ind.slot[task] = rnd() % slot_res.size();
+            return;
+        }
+        auto position = [&](int t) -> size_t {
+            return std::find(ind.order.begin(), ind.order.end(), t) - ind.order.begin();
+        };
+        size_t from = position(task);
+        size_t lo = 0, hi = n - 1;
+        for (auto [pred, w] : workflow.dependency_graph[task])
+            lo = std::max(lo, position(pred) + 1);
+        for (int succ : successors[task])
+            hi = std::min(hi, position(succ) - 1);
+        size_t to = lo + rnd() % (hi - lo + 1);
+        if (to < from)
+            std::rotate(ind.order.begin() + to, ind.order.begin() + from, ind.order.begin() + from + 1);
+        else
+            std::rotate(ind.order.begin() + from, ind.order.begin() + from + 1, ind.order.begin() + to + 1);
+    }
+
+    void hill_climb(Individual &ind) {
+        Arena &arena = arenas[0];
+        for (int step = 0; step < local_search; ++step) {
+            int task = rnd() % ind.slot.size();
+            int old_slot = ind.slot[task];
+            ind.slot[task] = rnd() % slot_res.size();
+            double value = fitness(ind, arena);
+            ++evaluations;
+            if (value < ind.fitness)
+                ind.fitness = value;
+            else
+                ind.slot[task] = old_slot;
+        }
+    }
+
+    void print_stats() const override {
+        HeftScheduler::print_stats();
+        std::cerr << "genetic: " << generations_done << " generations, " << evaluations << " evaluations, fitness " << heft_fitness << " of heft, " << best_fitness << " of the best" << std::endl;
+    }
+
+    ~GeneticScheduler() {}
+
+    int population_size = 32;
+    int generations = 100;
+    double time_budget = 1;  // seconds of wall time for the whole init
+    int replicas = 0;        // random sweeps added to the fitness
+    int local_search = 16;   // hill climb steps on the best individual per generation
+    size_t elite = 2;
+
+    std::vector<int> slot_base;  // first global slot id of every resource
+    std::vector<int> slot_res;
+    std::vector<Arena> arenas;
+    std::minstd_rand rnd;
+
+    int generations_done = 0;
+    std::atomic<long long> evaluations{0};
+    double heft_fitness = 0;
+    double best_fitness = 0;
+};
+
+#endif
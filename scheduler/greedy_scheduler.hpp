@@ -2,7 +2,9 @@
 #define SIMULATOR_GRREDY_SCHEDULER_HPP_
 
 #include "scheduler.hpp"
+#include "autoscaler.hpp"
 #include "../action.hpp"
+#include "../resource_index.hpp"
 #include "../workflow.hpp"
 
 #include <iostream>
@@ -10,55 +12,81 @@
 struct GreedyScheduler: public Scheduler {
     std::vector<Action> assign_available() {
         std::vector<Action> actions;
-        for (size_t i = 0; i < workflow.tasks.size(); ++i) {
-            if (!completed[i] && !scheduled[i] && dependencies_done(i)) {
-                for (size_t j = 0; j < resources.size(); ++j) {
-                    if (resources[j].used_slots < resources[j].slots && resources[j].is_up) {
-                        ++resources[j].used_slots;
-                        actions.emplace_back(i, j);
-                        scheduled[i] = true;
-                        tasks_on_res[j].insert(i);
-                        break;
-                    }
-                }
+        for (int i : ready) {
+            if (free_index.total_free() == 0)
+                break;
+            if (!scheduled[i]) {
+                int j = fastest_first ? free_index.fastest_free() : free_index.first_free();
+                ++resources[j].used_slots;
+                free_index.update(j, resources[j]);
+                actions.emplace_back(i, j);
+                scheduled[i] = true;
+                tasks_on_res[j].insert(i);
             }
         }
         return actions;
     }
 
+    // ready tasks not sent to any resource
+    std::vector<int> waiting() const {
+        std::vector<int> tasks;
+        for (int i : ready)
+            if (!scheduled[i])
+                tasks.push_back(i);
+        return tasks;
+    }
+
     std::vector<Action> init(const Settings &) override {
-        completed.assign(workflow.tasks.size(), false);
+        init_ready();
         scheduled.assign(workflow.tasks.size(), false);
         tasks_on_res.resize(resources.size());
-        return assign_available();
+        free_index.build(resources);
+        exec_model.build(workflow, resources);
+        autoscaler.init(*this);
+        auto actions = assign_available();
+        autoscaler.step(*this, waiting(), current_time);
+        return actions;
     }
 
     std::vector<Action> notify(const Event &event) override {
+        current_time = event.time;
+        autoscaler.notify(*this, event, current_time);
         if (event.event_type == Event::EVENT_TASK_FINISHED) {
-            completed[event.task_id] = true;
+            complete_task(event.task_id);
             resources[event.resource_id].used_slots--;
             tasks_on_res[event.resource_id].erase(event.task_id);
         } else if (event.event_type == Event::EVENT_TASK_FAILED) {
             resources[event.resource_id].used_slots--;
             scheduled[event.task_id] = false;
             tasks_on_res[event.resource_id].erase(event.task_id);
-        } else if (event.event_type == Event::EVENT_RESOURCE_DOWN) {
+        } else if (event.event_type == Event::EVENT_RESOURCE_DOWN || event.event_type == Event::EVENT_RESOURCE_REMOVED) {
             resources[event.resource_id].is_up = false;
+            resources[event.resource_id].removed |= event.event_type == Event::EVENT_RESOURCE_REMOVED;
             for (int task : tasks_on_res[event.resource_id]) {
                 scheduled[task] = false;
             }
             tasks_on_res[event.resource_id].clear();
-        } else if (event.event_type == Event::EVENT_RESOURCE_UP) {
+        } else if (event.event_type == Event::EVENT_RESOURCE_UP || event.event_type == Event::EVENT_RESOURCE_ADDED) {
+            tasks_on_res.resize(resources.size());
             resources[event.resource_id].is_up = true;
             resources[event.resource_id].used_slots = 0;
         }
-        return assign_available();
+        if (event.resource_id >= 0)
+            free_index.update(event.resource_id, resources[event.resource_id]);
+        auto actions = assign_available();
+        autoscaler.step(*this, waiting(), current_time);
+        return actions;
     }
 
     ~GreedyScheduler() {}
 
     std::vector<bool> scheduled;
     std::vector<std::set<int>> tasks_on_res;
+    ResourceIndex free_index;
+    bool fastest_first = false;  // place on the free resource with maximal Resource::speed instead of minimal id
+
+    Autoscaler autoscaler;
+    double current_time = 0;
 };
 
 #endif
@@ -2,11 +2,23 @@
 #define SIMULATOR_HEFT_SCHEDULER_HPP_
 
 #include "scheduler.hpp"
+#include "autoscaler.hpp"
+#include "local_search.hpp"
+#include "slot_choice.hpp"
 #include "../action.hpp"
+#include "../gap_index.hpp"
+#include "../plan_evaluator.hpp"
+#include "../resource_classes.hpp"
+#include "../resource_view.hpp"
+#include "../thread_pool.hpp"
 #include "../workflow.hpp"
 
 #include <iostream>
 #include <algorithm>
+#include <chrono>
+#include <memory>
+#include <numeric>
+#include <queue>
 
 struct HeftScheduler: public Scheduler {
     std::vector<Action> assign_available() {
@@ -26,17 +38,98 @@ struct HeftScheduler: public Scheduler {
                 }
             }
         }
+        // extra resources of the autoscaler are not in the plan, their free slots take the waiting task
+        // planned to start first
+        for (int res : autoscaler.scaled) {
+            if (!resources[res].is_up) continue;
+            for (int slot = 0; slot < resources[res].slots; ++slot) {
+                if (!resources[res].available_slots.count(slot) || !resource_schedules[res][slot].empty()) continue;
+                int best = -1;
+                for (int task : ready) {
+                    if (!tasks_on_res[task_res[task]].count(task) && (best == -1 || std::make_pair(task_est[task], task) < std::make_pair(task_est[best], best)))
+                        best = task;
+                }
+                if (best == -1)
+                    return plan;
+                resource_schedules[task_res[best]][task_slot[best]].erase({task_est[best], best});
+                task_res[best] = res;
+                task_slot[best] = slot;
+                resources[res].used_slots++;
+                resources[res].available_slots.erase(slot);
+                plan.push_back(Action(best, res));
+                tasks_on_res[res].insert(best);
+            }
+        }
         return plan;
     }
 
+    // ready tasks not sent to any resource
+    std::vector<int> waiting() const {
+        std::vector<int> tasks;
+        for (int task : ready)
+            if (!tasks_on_res[task_res[task]].count(task))
+                tasks.push_back(task);
+        return tasks;
+    }
+
     std::vector<Action> init(const Settings &settings) override {
+        plan(settings);
+        if (local_search_moves > 0)
+            improve_plan();
+        autoscaler.init(*this);
+        auto actions = assign_available();
+        autoscaler.step(*this, waiting(), current_time);
+        return actions;
+    }
+
+    // tasks by planned start, a topological order
+    std::vector<int> planned_order() const {
+        std::vector<int> order(workflow.tasks.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&](int a, int b) {
+            return std::make_pair(task_est[a], a) < std::make_pair(task_est[b], b);
+        });
+        return order;
+    }
+
+    // replaces the plan, slot_base[res] + slot is the global id of a slot, slots run their tasks by start
+    void set_plan(const std::vector<int> &slot_base, const std::vector<int> &global_slot, const std::vector<double> &start) {
+        for (auto &schedules : resource_schedules)
+            for (auto &schedule : schedules)
+                schedule.clear();
+        for (size_t task = 0; task < workflow.tasks.size(); ++task) {
+            task_res[task] = std::upper_bound(slot_base.begin(), slot_base.end(), global_slot[task]) - slot_base.begin() - 1;
+            task_slot[task] = global_slot[task] - slot_base[task_res[task]];
+            task_est[task] = start[task];
+            resource_schedules[task_res[task]][task_slot[task]].emplace(task_est[task], task);
+        }
+    }
+
+    // simulated annealing over the plan, see LocalSearch
+    void improve_plan() {
+        local_search.build(workflow, resources, exec_model, settings);
+        std::vector<int> global_slot(workflow.tasks.size());
+        for (size_t task = 0; task < workflow.tasks.size(); ++task)
+            global_slot[task] = local_search.slot_base[task_res[task]] + task_slot[task];
+        local_search_before = local_search.load(global_slot, planned_order());
+        auto start_time = std::chrono::steady_clock::now();
+        local_search.run(local_search_moves, local_search_budget, local_search_temperature);
+        local_search_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+        local_search_after = local_search.makespan();
+        if (local_search_after < local_search_before)
+            set_plan(local_search.slot_base, local_search.slot, local_search.evaluator.start);
+    }
+
+    // the static plan of all tasks, fills resource_schedules
+    void plan(const Settings &settings) {
         this->settings = settings;
-        completed.assign(workflow.tasks.size(), false);
+        init_ready();
         tasks_on_res.resize(resources.size());
         task_slot.resize(workflow.tasks.size());
         task_res.resize(workflow.tasks.size());
         task_est.resize(workflow.tasks.size());
         resource_schedules.resize(resources.size());
+        exec_model.build(workflow, resources);
 
         std::vector<std::vector<std::pair<int, int>>> inv_graph(workflow.tasks.size());
         for (int i = 0; i < workflow.tasks.size(); ++i) {
@@ -45,14 +138,7 @@ struct HeftScheduler: public Scheduler {
             }
         }
 
-        double avg_resource_time = 0;
-        {
-            int cnt = 0;
-            for (auto res : resources) {
-                cnt += res.slots;
-                avg_resource_time += res.slots * 1. / res.speed;
-            }
-        }
+        auto unit_time = exec_model.rank_unit_times(resources);
         std::vector<double> rank(workflow.tasks.size(), -1);
         std::priority_queue<std::pair<double, int>> pq;
 
@@ -63,7 +149,7 @@ struct HeftScheduler: public Scheduler {
                     dfs(succ);
                 rank[task] = std::max(rank[task], w / settings.net_speed + rank[succ]);
             }
-            rank[task] += std::max(1e-3, workflow.tasks[task].weight) * avg_resource_time;
+            rank[task] += std::max(1e-3, workflow.tasks[task].weight) * unit_time[exec_model.task_type[task]];
         };
         for (int i = 0; i < workflow.tasks.size(); ++i)
             if (rank[i] == -1)
@@ -72,11 +158,22 @@ struct HeftScheduler: public Scheduler {
         for (int i = 0; i < workflow.tasks.size(); ++i)
             pq.emplace(rank[i], i);
 
-        std::vector<std::vector<std::set<std::pair<double, double>>>> resource_allocations(resources.size());
+        std::vector<std::vector<GapIndex>> resource_allocations(resources.size());
         for (size_t i = 0; i < resource_allocations.size(); ++i) {
-            resource_allocations[i].assign(resources[i].slots, {{-1., 0.}});  // fake task at time=0 to avoid extra ifs
+            resource_allocations[i].assign(resources[i].slots, GapIndex(-1., 0.));  // fake task at time=0 to avoid extra ifs
             resource_schedules[i].resize(resources[i].slots);
         }
+        if (use_resource_classes) {
+            resource_classes.build(resources);
+            for (size_t i = 0; i < resources.size(); ++i)
+                for (int j = 0; j < resources[i].slots; ++j)
+                    resource_classes.add_slot(i, j, 0);
+        }
+
+        resource_view.build(resources);
+        std::fill(resource_view.earliest_free.begin(), resource_view.earliest_free.end(), 0);
+        std::vector<double> exec_time(resources.size());
+        std::vector<double> duration(resources.size());
 
         std::vector<double> eft(workflow.tasks.size(), 0);
         double estimated_finish = 0;
@@ -88,52 +185,102 @@ struct HeftScheduler: public Scheduler {
                 ready_time = std::max(ready_time, eft[succ]);
             }
             double task_time = std::max(1e-3, workflow.tasks[task].weight);
-            int best_res = -1;
-            int best_slot = -1;
-            double best_transfer_time = -1;
-            double best_est = -1;
-            for (int res = 0; res < resource_allocations.size(); ++res) {
+            exec_model.times(task, task_time, exec_time.data());
+            auto get_transfer_time = [&](int res) {
                 double transfer_time = 0;
                 for (auto [succ, w] : workflow.dependency_graph[task]) {
                     assert(task_res[succ] != -1);
                     if (settings.optimize_transfers && task_res[succ] == res) continue;
                     transfer_time = std::max(transfer_time, w / settings.net_speed);
                 }
-                for (int slot = 0; slot < resource_allocations[res].size(); ++slot) {
-                    double res_task_time = transfer_time + task_time / resources[res].speed + resources[res].delay * 0.55;
-                    auto it = resource_allocations[res][slot].lower_bound({ready_time, -1.});
-                    assert(it != resource_allocations[res][slot].begin());  // we have fake task
-                    it = prev(it);
-                    while (next(it) != resource_allocations[res][slot].end() && std::max(ready_time, it->second) + res_task_time >= next(it)->first)
-                        ++it;
-                    double start_time = std::max(ready_time, it->second);
-                    if (best_est == -1 || best_est > start_time) {
-                        best_est = start_time;
-                        best_slot = slot;
-                        best_res = res;
-                        best_transfer_time = transfer_time;
-                    }
+                return transfer_time;
+            };
+            // durations on all resources at once, then fix resources which already hold some predecessor data
+            resource_view.durations(get_transfer_time(-1), exec_time.data(), duration.data());
+            if (settings.optimize_transfers)
+                for (auto [succ, w] : workflow.dependency_graph[task])
+                    duration[task_res[succ]] = get_transfer_time(task_res[succ]) + exec_time[task_res[succ]] + resource_view.delay_time[task_res[succ]];
+
+            SlotChoice best;
+            best.upper_bound = resource_view.earliest_append_start(ready_time);
+            auto try_slot = [&](SlotChoice &best, int res, int slot) {
+                double res_task_time = duration[res];
+                // skip slots that can't start earlier than the best one (or as early, losing the tie)
+                if (best.dominates(resource_allocations[res][slot].lower_bound_start(ready_time, res_task_time), res, slot)) {
+                    ++best.pruned;
+                    return;
+                }
+                ++best.evaluated;
+                best.update(resource_allocations[res][slot].earliest_start(ready_time, res_task_time), res, slot);
+            };
+            auto try_resources = [&](SlotChoice &best, int begin, int end) {
+                for (int res = begin; res < end; ++res) {
+                    for (int slot = 0; slot < resource_allocations[res].size(); ++slot)
+                        try_slot(best, res, slot);
+                }
+            };
+            if (!use_resource_classes && resources.size() >= parallel_threshold) {
+                if (!pool)
+                    pool = std::make_shared<ThreadPool>();
+                std::vector<SlotChoice> worker_best(pool->size(), best);
+                pool->parallel_for(resources.size(), parallel_chunk, [&](int begin, int end, int worker) {
+                    try_resources(worker_best[worker], begin, end);
+                });
+                for (const auto &choice : worker_best)
+                    best.merge(choice);
+            } else if (!use_resource_classes) {
+                try_resources(best, 0, resources.size());
+            } else {
+                // resources holding predecessors have their own transfer time, check them separately
+                std::vector<int> local;
+                if (settings.optimize_transfers)
+                    for (auto [succ, w] : workflow.dependency_graph[task])
+                        local.push_back(task_res[succ]);
+                std::sort(local.begin(), local.end());
+                local.erase(std::unique(local.begin(), local.end()), local.end());
+                for (int res : local) {
+                    for (int slot = 0; slot < resource_allocations[res].size(); ++slot)
+                        try_slot(best, res, slot);
+                }
+                for (int cls = 0; cls < resource_classes.size(); ++cls) {
+                    auto [res, slot] = resource_classes.earliest(cls, local);
+                    if (res != -1)
+                        try_slot(best, res, slot);
                 }
             }
+            candidates_evaluated += best.evaluated;
+            candidates_pruned += best.pruned;
+            int best_res = best.res;
+            int best_slot = best.slot;
             assert(best_res != -1);
-            double start_time = best_est;
-            double finish_time = start_time + best_transfer_time + task_time / resources[best_res].speed + resources[best_res].delay * 0.55;
+            double start_time = best.est;
+            double finish_time = start_time + get_transfer_time(best_res) + exec_time[best_res] + resource_view.delay_time[best_res];
             estimated_finish = std::max(estimated_finish, finish_time);
-            resource_allocations[best_res][best_slot].emplace(start_time, finish_time);
+            resource_allocations[best_res][best_slot].insert(start_time, finish_time);
+            resource_view.earliest_free[best_res] = GapIndex::INF;
+            for (const auto &allocations : resource_allocations[best_res])
+                resource_view.earliest_free[best_res] = std::min(resource_view.earliest_free[best_res], allocations.last_end());
+            if (use_resource_classes)
+                resource_classes.set_slot_time(best_res, best_slot, resource_allocations[best_res][best_slot].last_end());
             eft[task] = finish_time;
             resource_schedules[best_res][best_slot].emplace(start_time, task);
             task_slot[task] = best_slot;
             task_res[task] = best_res;
             task_est[task] = start_time;
         }
-
-        return assign_available();
+        planned_finish = estimated_finish;
+        if (settings.scheduler_stats) {
+            PlanEvaluator evaluator;
+            evaluator.build(workflow, resources, exec_model, settings);
+            evaluated_finish = evaluator.evaluate(resource_schedules);
+        }
     }
 
     std::vector<Action> notify(const Event &event) override {
         current_time = event.time;
+        autoscaler.notify(*this, event, current_time);
         if (event.event_type == Event::EVENT_TASK_FINISHED) {
-            completed[event.task_id] = true;
+            complete_task(event.task_id);
             resources[event.resource_id].used_slots--;
             resources[event.resource_id].return_slot(task_slot[event.task_id]);
             tasks_on_res[event.resource_id].erase(event.task_id);
@@ -152,8 +299,30 @@ struct HeftScheduler: public Scheduler {
             resources[event.resource_id].is_up = true;
             resources[event.resource_id].used_slots = 0;
             resources[event.resource_id].fill_slots();
+        } else if (event.event_type == Event::EVENT_RESOURCE_ADDED) {
+            // the static plan does not use new resources, assign_available gives them waiting tasks
+            tasks_on_res.resize(resources.size());
+            for (size_t i = resource_schedules.size(); i < resources.size(); ++i)
+                resource_schedules.emplace_back(resources[i].slots);
+            resources[event.resource_id].is_up = true;
+        } else if (event.event_type == Event::EVENT_RESOURCE_REMOVED) {
+            // the autoscaler releases only idle extra resources and stops giving them tasks at once,
+            // the plan never has tasks there
+            resources[event.resource_id].is_up = false;
+            resources[event.resource_id].removed = true;
+        }
+        auto actions = assign_available();
+        autoscaler.step(*this, waiting(), current_time);
+        return actions;
+    }
+
+    void print_stats() const override {
+        std::cerr << "candidates evaluated: " << candidates_evaluated << ", pruned: " << candidates_pruned << std::endl;
+        std::cerr << "plan makespan: " << planned_finish << " planned, " << evaluated_finish << " expected" << std::endl;
+        if (local_search_moves > 0) {
+            std::cerr << "local search: " << local_search.tried << " moves in " << local_search_time << " s, " << local_search.accepted << " accepted, "
+                      << local_search.recomputed << " task recomputations, makespan " << local_search_before << " -> " << local_search_after << std::endl;
         }
-        return assign_available();
     }
 
     ~HeftScheduler() {}
@@ -165,6 +334,31 @@ struct HeftScheduler: public Scheduler {
     std::vector<double> task_est;
     std::vector<std::set<int>> tasks_on_res;
     double current_time = 0;
+    Autoscaler autoscaler;
+
+    // evaluate one slot per class of identical resources instead of every slot
+    bool use_resource_classes = false;
+    ResourceClasses resource_classes;
+    ResourceView resource_view;
+
+    // processor selection is split over threads from this number of resources
+    size_t parallel_threshold = 1024;
+    int parallel_chunk = 64;
+    std::shared_ptr<ThreadPool> pool;
+
+    long long candidates_evaluated = 0;
+    long long candidates_pruned = 0;
+    // simulated annealing after planning, off with 0 moves
+    long long local_search_moves = 0;
+    double local_search_budget = 1;         // seconds of wall time
+    double local_search_temperature = 0.01;  // initial temperature as a part of the makespan
+    LocalSearch local_search;
+    double local_search_before = 0;
+    double local_search_after = 0;
+    double local_search_time = 0;
+
+    double planned_finish = 0;    // end of the plan made at init
+    double evaluated_finish = 0;  // its makespan by PlanEvaluator, with scheduler_stats only
 };
 
 #endif
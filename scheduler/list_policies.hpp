@@ -0,0 +1,273 @@
+#ifndef SIMULATOR_LIST_POLICIES_HPP_
+#define SIMULATOR_LIST_POLICIES_HPP_
+
+#include "optimistic_cost_table.hpp"
+#include "scheduler.hpp"
+#include "../gap_index.hpp"
+#include "../settings.hpp"
+
+#include <algorithm>
+#include <vector>
+
+// policies of ListScheduler. a priority policy fills priorities of tasks, a task with higher priority
+// is placed first among tasks whose predecessors are placed. a placement policy gives the start of a task
+// on a slot timeline and the key to compare slots by, the smallest key wins. the scheduler keeps
+// one placement object and calls its init once before planning
+namespace list_policies {
+
+// predecessors go before successors
+inline std::vector<int> topological_order(const Scheduler &scheduler) {
+    const auto &workflow = scheduler.workflow;
+    std::vector<int> left(workflow.tasks.size());
+    std::vector<int> order;
+    for (size_t i = 0; i < workflow.tasks.size(); ++i) {
+        left[i] = workflow.dependency_graph[i].size();
+        if (left[i] == 0)
+            order.push_back(i);
+    }
+    for (size_t k = 0; k < order.size(); ++k) {
+        for (int succ : scheduler.successors[order[k]]) {
+            if (--left[succ] == 0)
+                order.push_back(succ);
+        }
+    }
+    return order;
+}
+
+// execution time of the task averaged over resources
+inline double mean_exec_time(const Scheduler &scheduler, int task) {
+    double weight = std::max(1e-3, scheduler.workflow.tasks[task].weight);
+    double sum = 0;
+    for (size_t r = 0; r < scheduler.resources.size(); ++r)
+        sum += scheduler.exec_model.time(task, r, weight) + scheduler.resources[r].delay * 0.55;
+    return sum / scheduler.resources.size();
+}
+
+// longest path from the task to an exit, including the task
+inline std::vector<double> upward_rank(const Scheduler &scheduler, const Settings &settings) {
+    const auto &workflow = scheduler.workflow;
+    auto order = topological_order(scheduler);
+    std::vector<double> rank(workflow.tasks.size(), 0);
+    std::vector<double> succ_rank(workflow.tasks.size(), 0);  // max over successors of transfer + their rank
+    for (auto it = order.rbegin(); it != order.rend(); ++it) {
+        int task = *it;
+        rank[task] = mean_exec_time(scheduler, task) + succ_rank[task];
+        for (auto [pred, w] : workflow.dependency_graph[task])
+            succ_rank[pred] = std::max(succ_rank[pred], w / settings.net_speed + rank[task]);
+    }
+    return rank;
+}
+
+// longest path from an entry to the task, not including the task
+inline std::vector<double> downward_rank(const Scheduler &scheduler, const Settings &settings) {
+    const auto &workflow = scheduler.workflow;
+    std::vector<double> rank(workflow.tasks.size(), 0);
+    for (int task : topological_order(scheduler)) {
+        for (auto [pred, w] : workflow.dependency_graph[task])
+            rank[task] = std::max(rank[task], rank[pred] + mean_exec_time(scheduler, pred) + w / settings.net_speed);
+    }
+    return rank;
+}
+
+// tasks in order of ids
+struct FifoPriority {
+    static std::vector<double> compute(const Scheduler &scheduler, const Settings &) {
+        std::vector<double> priority(scheduler.workflow.tasks.size());
+        for (size_t i = 0; i < priority.size(); ++i)
+            priority[i] = -(double)i;
+        return priority;
+    }
+};
+
+// HEFT order, the longest way to the end first
+struct UpwardRankPriority {
+    static std::vector<double> compute(const Scheduler &scheduler, const Settings &settings) {
+        return upward_rank(scheduler, settings);
+    }
+};
+
+// tasks closer to the start first
+struct DownwardRankPriority {
+    static std::vector<double> compute(const Scheduler &scheduler, const Settings &settings) {
+        auto priority = downward_rank(scheduler, settings);
+        for (auto &p : priority)
+            p = -p;
+        return priority;
+    }
+};
+
+// CPOP order, tasks on the longest paths through the whole workflow first
+struct CriticalPathPriority {
+    static std::vector<double> compute(const Scheduler &scheduler, const Settings &settings) {
+        auto priority = upward_rank(scheduler, settings);
+        auto down = downward_rank(scheduler, settings);
+        for (size_t i = 0; i < priority.size(); ++i)
+            priority[i] += down[i];
+        return priority;
+    }
+};
+
+// PEFT order, the largest mean optimistic cost first
+struct PeftPriority {
+    static std::vector<double> compute(const Scheduler &scheduler, const Settings &settings) {
+        OptimisticCostTable table;
+        table.build(scheduler, settings, topological_order(scheduler));
+        std::vector<double> priority(scheduler.workflow.tasks.size());
+        for (size_t i = 0; i < priority.size(); ++i)
+            priority[i] = table.mean(i);
+        return priority;
+    }
+};
+
+// placement which needs nothing but the timeline
+struct StatelessPlacement {
+    void init(const Scheduler &, const Settings &) {}
+
+    constexpr static bool joint = false;
+};
+
+// after the last task of the slot, the slot where the task starts earliest wins regardless of its speed
+struct FirstFitPlacement: public StatelessPlacement {
+    static double start(const GapIndex &timeline, double ready_time, double) {
+        return std::max(ready_time, timeline.last_end());
+    }
+
+    static double key(int, int, double start, double) {
+        return start;
+    }
+};
+
+// after the last task of the slot, the earliest finish wins
+struct EftPlacement: public StatelessPlacement {
+    static double start(const GapIndex &timeline, double ready_time, double) {
+        return std::max(ready_time, timeline.last_end());
+    }
+
+    static double key(int, int, double start, double duration) {
+        return start + duration;
+    }
+};
+
+// into the first idle gap of the slot where the task fits, the earliest finish wins
+struct InsertionEftPlacement: public StatelessPlacement {
+    static double start(const GapIndex &timeline, double ready_time, double duration) {
+        return timeline.earliest_start(ready_time, duration);
+    }
+
+    static double key(int, int, double start, double duration) {
+        return start + duration;
+    }
+};
+
+// PEFT lookahead: insertion, the earliest finish plus the optimistic cost of the rest of the workflow wins
+struct PeftPlacement {
+    void init(const Scheduler &scheduler, const Settings &settings) {
+        table.build(scheduler, settings, topological_order(scheduler));
+    }
+
+    static double start(const GapIndex &timeline, double ready_time, double duration) {
+        return timeline.earliest_start(ready_time, duration);
+    }
+
+    double key(int task, int res, double start, double duration) const {
+        return start + duration + table.cost(task, res);
+    }
+
+    constexpr static bool joint = false;
+
+    OptimisticCostTable table;
+};
+
+// CPOP: tasks of the critical path (the entry task and then every time the successor with the largest
+// upward + downward rank) go to the resource that runs the whole path fastest, the rest by insertion EFT.
+// if that resource is down, critical tasks go by insertion EFT too
+struct CpopPlacement {
+    void init(const Scheduler &scheduler, const Settings &settings) {
+        this->scheduler = &scheduler;
+        auto priority = CriticalPathPriority::compute(scheduler, settings);
+        on_path.assign(scheduler.workflow.tasks.size(), false);
+        std::vector<int> path;
+        int task = -1;
+        for (size_t i = 0; i < priority.size(); ++i) {
+            if (scheduler.workflow.dependency_graph[i].empty() && (task == -1 || priority[i] > priority[task]))
+                task = i;
+        }
+        while (task != -1) {
+            on_path[task] = true;
+            path.push_back(task);
+            int next = -1;
+            for (int succ : scheduler.successors[task]) {
+                if (next == -1 || priority[succ] > priority[next])
+                    next = succ;
+            }
+            task = next;
+        }
+        double best_time = 0;
+        for (size_t r = 0; r < scheduler.resources.size(); ++r) {
+            double time = 0;
+            for (int t : path)
+                time += scheduler.exec_model.time(t, r, std::max(1e-3, scheduler.workflow.tasks[t].weight)) + scheduler.resources[r].delay * 0.55;
+            if (path_res == -1 || time < best_time) {
+                path_res = r;
+                best_time = time;
+            }
+        }
+    }
+
+    static double start(const GapIndex &timeline, double ready_time, double duration) {
+        return timeline.earliest_start(ready_time, duration);
+    }
+
+    double key(int task, int res, double start, double duration) const {
+        if (on_path[task] && res != path_res && path_res != -1 && scheduler->resources[path_res].is_up)
+            return GapIndex::INF;
+        return start + duration;
+    }
+
+    constexpr static bool joint = false;
+
+    const Scheduler *scheduler = nullptr;
+    std::vector<bool> on_path;
+    int path_res = -1;
+};
+
+// dynamic level scheduling: among all tasks whose predecessors are placed, the pair of a task and a slot with
+// the largest dynamic level static_level - start + (mean time - time on the resource) is placed next.
+// static level is the longest path of mean execution times to an exit, transfers ignored
+struct DlsPlacement {
+    void init(const Scheduler &scheduler, const Settings &) {
+        this->scheduler = &scheduler;
+        const auto &workflow = scheduler.workflow;
+        mean_time.resize(workflow.tasks.size());
+        static_level.assign(workflow.tasks.size(), 0);
+        auto order = topological_order(scheduler);
+        for (auto it = order.rbegin(); it != order.rend(); ++it) {
+            int task = *it;
+            mean_time[task] = mean_exec_time(scheduler, task);
+            double level = 0;
+            for (int succ : scheduler.successors[task])
+                level = std::max(level, static_level[succ]);
+            static_level[task] = mean_time[task] + level;
+        }
+    }
+
+    static double start(const GapIndex &timeline, double ready_time, double) {
+        return std::max(ready_time, timeline.last_end());
+    }
+
+    // minus the dynamic level
+    double key(int task, int res, double start, double) const {
+        double time = scheduler->exec_model.time(task, res, std::max(1e-3, scheduler->workflow.tasks[task].weight)) + scheduler->resources[res].delay * 0.55;
+        return start - static_level[task] - (mean_time[task] - time);
+    }
+
+    constexpr static bool joint = true;
+
+    const Scheduler *scheduler = nullptr;
+    std::vector<double> mean_time;
+    std::vector<double> static_level;
+};
+
+}  // namespace list_policies
+
+#endif
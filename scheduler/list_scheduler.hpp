@@ -0,0 +1,280 @@
+#ifndef SIMULATOR_LIST_SCHEDULER_HPP_
+#define SIMULATOR_LIST_SCHEDULER_HPP_
+
+#include "list_policies.hpp"
+#include "scheduler.hpp"
+#include "../action.hpp"
+#include "../gap_index.hpp"
+#include "../resource_view.hpp"
+#include "../workflow.hpp"
+
+#include <iostream>
+#include <algorithm>
+#include <memory>
+#include <queue>
+#include <string>
+
+// list scheduling with the task order and the slot choice given at compile time (see list_policies.hpp),
+// so the placement loop has no virtual calls. all tasks which are not running are planned at init and
+// again after every failure or change of resources, each slot runs its planned tasks in order of start.
+// with Placement::joint the next task is not taken by priority, but the (task, slot) pair with the smallest key
+// over all candidates is placed
+template<typename Priority, typename Placement>
+struct ListScheduler: public Scheduler {
+    struct Choice {
+        int res = -1;
+        int slot = -1;
+        double start = 0;
+        double finish = 0;
+        double key = 0;
+    };
+
+    std::vector<Action> assign_available() {
+        std::vector<Action> plan;
+        for (int res = 0; res < (int)resources.size(); ++res) {
+            if (!resources[res].is_up) continue;
+            for (int slot = 0; slot < resources[res].slots; ++slot) {
+                if (resources[res].available_slots.count(slot) && !resource_schedules[res][slot].empty()) {
+                    auto [start, task] = *resource_schedules[res][slot].begin();
+                    if (dependencies_done(task)) {
+                        resource_schedules[res][slot].erase(resource_schedules[res][slot].begin());
+                        resources[res].used_slots++;
+                        resources[res].available_slots.erase(slot);
+                        plan.push_back(Action(task, res));
+                        tasks_on_res[res].insert(task);
+                        scheduled[task] = true;
+                        task_eft[task] = current_time + task_eft[task] - task_est[task];
+                        slot_free_time[res][slot] = task_eft[task];
+                    }
+                }
+            }
+        }
+        return plan;
+    }
+
+    std::vector<Action> init(const Settings &settings) override {
+        this->settings = settings;
+        init_ready();
+        tasks_on_res.resize(resources.size());
+        task_res.assign(workflow.tasks.size(), -1);
+        task_slot.assign(workflow.tasks.size(), -1);
+        task_est.assign(workflow.tasks.size(), 0);
+        task_eft.assign(workflow.tasks.size(), 0);
+        scheduled.assign(workflow.tasks.size(), false);
+        slot_free_time.resize(resources.size());
+        for (size_t i = 0; i < resources.size(); ++i)
+            slot_free_time[i].assign(resources[i].slots, 0);
+        exec_model.build(workflow, resources);
+        resource_view.build(resources);
+        exec_time.resize(resources.size());
+        duration.resize(resources.size());
+        placement.init(*this, settings);
+        priority = Priority::compute(*this, settings);
+        plan();
+        return assign_available();
+    }
+
+    // places tasks by priority, a task becomes a candidate when all its predecessors are placed, running or completed
+    void plan() {
+        resource_schedules.assign(resources.size(), {});
+        timelines.assign(resources.size(), {});
+        for (size_t i = 0; i < resources.size(); ++i) {
+            resource_schedules[i].resize(resources[i].slots);
+            for (int j = 0; j < resources[i].slots; ++j)
+                timelines[i].emplace_back(-1, slot_free_time[i][j]);  // fake task till the slot is free
+        }
+        std::vector<int> left(workflow.tasks.size(), 0);
+        std::vector<int> first;
+        for (size_t i = 0; i < workflow.tasks.size(); ++i) {
+            if (completed[i] || scheduled[i]) continue;
+            for (auto [pred, w] : workflow.dependency_graph[i])
+                left[i] += !completed[pred] && !scheduled[pred];
+            if (left[i] == 0)
+                first.push_back(i);
+        }
+        estimated_finish = current_time;
+        if constexpr (Placement::joint) {
+            std::vector<int> candidates = first;
+            while (!candidates.empty()) {
+                Choice best;
+                size_t best_i = 0;
+                for (size_t i = 0; i < candidates.size(); ++i) {
+                    Choice choice = choose(candidates[i]);
+                    if (choice.res == -1) continue;
+                    if (best.res == -1 || choice.key < best.key || (choice.key == best.key && candidates[i] < candidates[best_i])) {
+                        best = choice;
+                        best_i = i;
+                    }
+                }
+                // no resource is up, everything waits for the next replan
+                if (best.res == -1)
+                    break;
+                int task = candidates[best_i];
+                candidates[best_i] = candidates.back();
+                candidates.pop_back();
+                commit(task, best);
+                for (int succ : successors[task]) {
+                    if (--left[succ] == 0)
+                        candidates.push_back(succ);
+                }
+            }
+        } else {
+            std::priority_queue<std::pair<double, int>> candidates;
+            for (int task : first)
+                candidates.emplace(priority[task], -task);
+            while (!candidates.empty()) {
+                int task = -candidates.top().second;
+                candidates.pop();
+                Choice choice = choose(task);
+                if (choice.res == -1)
+                    break;
+                commit(task, choice);
+                for (int succ : successors[task]) {
+                    if (--left[succ] == 0)
+                        candidates.emplace(priority[succ], -succ);
+                }
+            }
+        }
+        if (replans++ == 0)
+            initial_estimated_finish = estimated_finish;
+    }
+
+    double transfer_time(int task, int res) const {
+        double time = 0;
+        for (auto [pred, w] : workflow.dependency_graph[task]) {
+            if (settings.optimize_transfers && task_res[pred] == res) continue;
+            time = std::max(time, w / settings.net_speed);
+        }
+        return time;
+    }
+
+    // the best slot for the task, res = -1 if no resource is up
+    Choice choose(int task) {
+        double ready_time = current_time;
+        for (auto [pred, w] : workflow.dependency_graph[task])
+            ready_time = std::max(ready_time, task_eft[pred]);
+        exec_model.times(task, std::max(1e-3, workflow.tasks[task].weight), exec_time.data());
+        resource_view.durations(transfer_time(task, -1), exec_time.data(), duration.data());
+        if (settings.optimize_transfers)
+            for (auto [pred, w] : workflow.dependency_graph[task])
+                duration[task_res[pred]] = transfer_time(task, task_res[pred]) + exec_time[task_res[pred]] + resource_view.delay_time[task_res[pred]];
+
+        Choice best;
+        for (int res = 0; res < (int)resources.size(); ++res) {
+            if (!resources[res].is_up) continue;
+            for (int slot = 0; slot < resources[res].slots; ++slot) {
+                double start = placement.start(timelines[res][slot], ready_time, duration[res]);
+                double key = placement.key(task, res, start, duration[res]);
+                if (best.res == -1 || key < best.key) {
+                    best.res = res;
+                    best.slot = slot;
+                    best.start = start;
+                    best.key = key;
+                }
+            }
+        }
+        if (best.res != -1)
+            best.finish = best.start + duration[best.res];
+        return best;
+    }
+
+    void commit(int task, const Choice &choice) {
+        timelines[choice.res][choice.slot].insert(choice.start, choice.finish);
+        resource_schedules[choice.res][choice.slot].emplace(choice.start, task);
+        task_res[task] = choice.res;
+        task_slot[task] = choice.slot;
+        task_est[task] = choice.start;
+        task_eft[task] = choice.finish;
+        estimated_finish = std::max(estimated_finish, choice.finish);
+    }
+
+    std::vector<Action> notify(const Event &event) override {
+        current_time = event.time;
+        if (event.event_type == Event::EVENT_TASK_FINISHED) {
+            complete_task(event.task_id);
+            resources[event.resource_id].used_slots--;
+            resources[event.resource_id].return_slot(task_slot[event.task_id]);
+            tasks_on_res[event.resource_id].erase(event.task_id);
+            task_eft[event.task_id] = current_time;
+            slot_free_time[event.resource_id][task_slot[event.task_id]] = current_time;
+            return assign_available();
+        }
+        if (event.event_type == Event::EVENT_TASK_FAILED) {
+            resources[event.resource_id].used_slots--;
+            resources[event.resource_id].return_slot(task_slot[event.task_id]);
+            tasks_on_res[event.resource_id].erase(event.task_id);
+            scheduled[event.task_id] = false;
+            slot_free_time[event.resource_id][task_slot[event.task_id]] = current_time;
+        } else if (event.event_type == Event::EVENT_RESOURCE_DOWN || event.event_type == Event::EVENT_RESOURCE_REMOVED) {
+            resources[event.resource_id].is_up = false;
+            resources[event.resource_id].removed |= event.event_type == Event::EVENT_RESOURCE_REMOVED;
+            for (int task : tasks_on_res[event.resource_id])
+                scheduled[task] = false;
+            tasks_on_res[event.resource_id].clear();
+        } else if (event.event_type == Event::EVENT_RESOURCE_UP || event.event_type == Event::EVENT_RESOURCE_ADDED) {
+            resources[event.resource_id].is_up = true;
+            if (event.event_type == Event::EVENT_RESOURCE_UP) {
+                resources[event.resource_id].used_slots = 0;
+                resources[event.resource_id].fill_slots();
+            }
+            slot_free_time[event.resource_id].assign(resources[event.resource_id].slots, current_time);
+        }
+        plan();
+        return assign_available();
+    }
+
+    void print_stats() const override {
+        std::cerr << "replans: " << replans << std::endl;
+        std::cerr << "estimated makespan: " << initial_estimated_finish << " at start, " << estimated_finish << " in the last plan" << std::endl;
+    }
+
+    ~ListScheduler() {}
+
+    Settings settings;
+    Placement placement;
+    std::vector<double> priority;
+    std::vector<std::vector<std::set<std::pair<double, int>>>> resource_schedules;
+    std::vector<std::vector<GapIndex>> timelines;
+    std::vector<std::vector<double>> slot_free_time;
+    std::vector<int> task_slot;
+    std::vector<int> task_res;
+    std::vector<double> task_est;
+    std::vector<double> task_eft;
+    std::vector<std::set<int>> tasks_on_res;
+    std::vector<bool> scheduled;
+    double current_time = 0;
+
+    ResourceView resource_view;
+    std::vector<double> exec_time;
+    std::vector<double> duration;
+
+    double estimated_finish = 0;          // end of the last plan
+    double initial_estimated_finish = 0;  // end of the plan made at init
+    long long replans = 0;
+};
+
+template<typename Priority>
+std::shared_ptr<Scheduler> make_list_scheduler(const std::string &placement) {
+    if (placement == "first_fit")
+        return std::make_shared<ListScheduler<Priority, list_policies::FirstFitPlacement>>();
+    if (placement == "eft")
+        return std::make_shared<ListScheduler<Priority, list_policies::EftPlacement>>();
+    if (placement == "insertion_eft")
+        return std::make_shared<ListScheduler<Priority, list_policies::InsertionEftPlacement>>();
+    return nullptr;
+}
+
+// list scheduler by names of its policies, nullptr if there is no such policy
+inline std::shared_ptr<Scheduler> make_list_scheduler(const std::string &priority, const std::string &placement) {
+    if (priority == "fifo")
+        return make_list_scheduler<list_policies::FifoPriority>(placement);
+    if (priority == "upward_rank")
+        return make_list_scheduler<list_policies::UpwardRankPriority>(placement);
+    if (priority == "downward_rank")
+        return make_list_scheduler<list_policies::DownwardRankPriority>(placement);
+    if (priority == "critical_path")
+        return make_list_scheduler<list_policies::CriticalPathPriority>(placement);
+    return nullptr;
+}
+
+#endif
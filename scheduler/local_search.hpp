@@ -0,0 +1,256 @@
+#ifndef SIMULATOR_LOCAL_SEARCH_HPP_
+#define SIMULATOR_LOCAL_SEARCH_HPP_
+
+#include "../execution_model.hpp"
+#include "../plan_evaluator.hpp"
+#include "../resource.hpp"
+#include "../settings.hpp"
+#include "../workflow.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <iterator>
+#include <queue>
+#include <random>
+#include <set>
+#include <tuple>
+#include <vector>
+
+// simulated annealing over a static plan. moves: a task goes to another slot, two tasks of different slots
+// swap slots, two neighbours of the order without a dependency swap places. tasks of a slot run in the order,
+// which stays topological, so after a move only tasks reachable from the changed ones through dependencies
+// and slot order are recomputed, by increasing position, and propagation stops where finish times stay the same.
+// the makespan is kept in a max tree over finish times, a rejected move is rolled back from a journal
+struct LocalSearch {
+    // slots of resources get global ids from 0 in order of resources
+    void build(const Workflow &workflow, const std::vector<Resource> &resources, const ExecutionModel &exec_model, const Settings &settings) {
+        evaluator.build(workflow, resources, exec_model, settings);
+        slot_res.clear();
+        slot_base.assign(resources.size() + 1, 0);
+        for (size_t res = 0; res < resources.size(); ++res) {
+            slot_base[res + 1] = slot_base[res] + resources[res].slots;
+            slot_res.insert(slot_res.end(), resources[res].slots, res);
+        }
+        size_t n = workflow.tasks.size();
+        slot.resize(n);
+        res.resize(n);
+        prev.resize(n);
+        next.resize(n);
+        pos.resize(n);
+        queued.assign(n, false);
+        tree_size = 1;
+        while (tree_size < n)
+            tree_size *= 2;
+        tree.assign(2 * tree_size, 0);
+    }
+
+    // takes the plan: global slot of every task and a topological order, tasks of a slot run in that order
+    double load(const std::vector<int> &task_slot, const std::vector<int> &task_order) {
+        slot = task_slot;
+        order = task_order;
+        slot_tasks.assign(slot_res.size(), {});
+        for (size_t i = 0; i < order.size(); ++i) {
+            int task = order[i];
+            pos[task] = i;
+            res[task] = slot_res[slot[task]];
+            slot_tasks[slot[task]].emplace(i, task);
+        }
+        for (const auto &tasks : slot_tasks) {
+            int last = -1;
+            for (auto [p, task] : tasks) {
+                prev[task] = last;
+                if (last != -1)
+                    next[last] = task;
+                last = task;
+            }
+            if (last != -1)
+                next[last] = -1;
+        }
+        double makespan = evaluator.evaluate(res.data(), prev.data());
+        for (size_t task = 0; task < order.size(); ++task)
+            set_finish(task, evaluator.finish[task]);
+        return makespan;
+    }
+
+    void set_finish(int task, double value) {
+        int v = tree_size + task;
+        tree[v] = value;
+        for (v /= 2; v >= 1; v /= 2)
+            tree[v] = std::max(tree[2 * v], tree[2 * v + 1]);
+    }
+
+    double makespan() const {
+        return tree[1];
+    }
+
+    void detach(int task) {
+        slot_tasks[slot[task]].erase({pos[task], task});
+        if (prev[task] != -1)
+            next[prev[task]] = next[task];
+        if (next[task] != -1) {
+            prev[next[task]] = prev[task];
+            touch(next[task]);
+        }
+    }
+
+    void attach(int task, int new_slot) {
+        slot[task] = new_slot;
+        res[task] = slot_res[new_slot];
+        auto it = slot_tasks[new_slot].emplace(pos[task], task).first;
+        prev[task] = it == slot_tasks[new_slot].begin() ? -1 : std::prev(it)->second;
+        next[task] = std::next(it) == slot_tasks[new_slot].end() ? -1 : std::next(it)->second;
+        if (prev[task] != -1)
+            next[prev[task]] = task;
+        if (next[task] != -1) {
+            prev[next[task]] = task;
+            touch(next[task]);
+        }
+        touch(task);
+        // successors may lose or gain local input
+        for (int k = evaluator.succ_begin[task]; k < evaluator.succ_begin[task + 1]; ++k)
+            touch(evaluator.succs[k]);
+    }
+
+    void move(int task, int new_slot) {
+        detach(task);
+        attach(task, new_slot);
+    }
+
+    // swaps order[i] and order[i + 1], false if the second one depends on the first
+    bool swap_order(int i) {
+        int a = order[i], b = order[i + 1];
+        for (int k = evaluator.pred_begin[b]; k < evaluator.pred_begin[b + 1]; ++k) {
+            if (evaluator.preds[k] == a)
+                return false;
+        }
+        int slot_a = slot[a], slot_b = slot[b];
+        detach(a);
+        detach(b);
+        std::swap(order[i], order[i + 1]);
+        pos[a] = i + 1;
+        pos[b] = i;
+        attach(a, slot_a);
+        attach(b, slot_b);
+        return true;
+    }
+
+    void touch(int task) {
+        if (!queued[task]) {
+            queued[task] = true;
+            dirty.emplace(pos[task], task);
+        }
+    }
+
+    // recomputes touched tasks and everything their new finish times reach
+    void propagate() {
+        while (!dirty.empty()) {
+            int task = dirty.top().second;
+            dirty.pop();
+            queued[task] = false;
+            double start = evaluator.start[task];
+            double finish = evaluator.finish[task];
+            if (evaluator.settle(task, res.data(), prev[task]) == finish && evaluator.start[task] == start)
+                continue;
+            ++recomputed;
+            journal.emplace_back(task, start, finish);
+            set_finish(task, evaluator.finish[task]);
+            for (int k = evaluator.succ_begin[task]; k < evaluator.succ_begin[task + 1]; ++k)
+                touch(evaluator.succs[k]);
+            if (next[task] != -1)
+                touch(next[task]);
+        }
+    }
+
+    void rollback() {
+        for (auto it = journal.rbegin(); it != journal.rend(); ++it) {
+            auto [task, start, finish] = *it;
+            evaluator.start[task] = start;
+            evaluator.finish[task] = finish;
+            set_finish(task, finish);
+        }
+    }
+
+    // anneals for the given number of moves or seconds, the best plan found is left in slot and order
+    void run(long long moves, double time_budget, double temperature) {
+        auto start_time = std::chrono::steady_clock::now();
+        size_t n = order.size();
+        double current = makespan();
+        double best = current;
+        std::vector<int> best_slot = slot, best_order = order;
+        double t0 = temperature * current;
+        for (tried = 0; tried < moves && n > 1; ++tried) {
+            if (tried % 256 == 0 && std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count() >= time_budget)
+                break;
+            journal.clear();
+            int kind = rnd() % 3;
+            int a = rnd() % n, b = rnd() % n;
+            int i = rnd() % (n - 1);
+            int old_a = slot[a], old_b = slot[b];
+            if (kind == 0) {
+                move(a, rnd() % slot_res.size());
+            } else if (kind == 1) {
+                if (old_a == old_b)
+                    continue;
+                move(a, old_b);
+                move(b, old_a);
+            } else if (!swap_order(i)) {
+                continue;
+            }
+            propagate();
+            double value = makespan();
+            double t = t0 * (1 - (double)tried / moves);
+            if (value <= current || (t > 0 && std::uniform_real_distribution<>(0, 1)(rnd) < std::exp((current - value) / t))) {
+                current = value;
+                ++accepted;
+                if (value < best) {
+                    best = value;
+                    best_slot = slot;
+                    best_order = order;
+                }
+                continue;
+            }
+            // undo the move, its own touches recompute nothing as times are restored first
+            rollback();
+            if (kind == 0) {
+                move(a, old_a);
+            } else if (kind == 1) {
+                move(b, old_b);
+                move(a, old_a);
+            } else {
+                swap_order(i);
+            }
+            while (!dirty.empty()) {
+                queued[dirty.top().second] = false;
+                dirty.pop();
+            }
+        }
+        load(best_slot, best_order);
+    }
+
+    PlanEvaluator evaluator;  // start and finish of the current plan
+    std::vector<int> slot_base;
+    std::vector<int> slot_res;
+
+    std::vector<int> slot;
+    std::vector<int> res;
+    std::vector<int> order;
+    std::vector<int> pos;     // position in order
+    std::vector<int> prev;    // previous task of the slot
+    std::vector<int> next;
+    std::vector<std::set<std::pair<int, int>>> slot_tasks;  // tasks of every slot by position
+
+    std::priority_queue<std::pair<int, int>, std::vector<std::pair<int, int>>, std::greater<std::pair<int, int>>> dirty;
+    std::vector<bool> queued;
+    std::vector<std::tuple<int, double, double>> journal;  // task, old start, old finish
+    size_t tree_size = 1;
+    std::vector<double> tree;
+    std::minstd_rand rnd;
+
+    long long tried = 0;
+    long long accepted = 0;
+    long long recomputed = 0;
+};
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef SIMULATOR_OPTIMISTIC_COST_TABLE_HPP_
+#define SIMULATOR_OPTIMISTIC_COST_TABLE_HPP_
+
+#include "scheduler.hpp"
+#include "../resource_view.hpp"
+#include "../settings.hpp"
+#include "../simd.hpp"
+
+#include <algorithm>
+#include <vector>
+
+// PEFT optimistic cost table: cost(t, p) is the shortest time from the end of task t on resource p
+// to the end of the workflow, when every later task runs on its best resource and waits for nothing
+// but transfers. rows of tasks are contiguous, so a row is updated by simd kernels in one pass
+struct OptimisticCostTable {
+    // order is topological, predecessors first
+    void build(const Scheduler &scheduler, const Settings &settings, const std::vector<int> &order) {
+        const auto &workflow = scheduler.workflow;
+        n = scheduler.resources.size();
+        table.assign(workflow.tasks.size() * n, 0);
+        ResourceView view;
+        view.build(scheduler.resources);
+        std::vector<double> exec_time(n);
+        std::vector<double> row(n);  // cost(s, w) + duration of s on w
+        for (auto it = order.rbegin(); it != order.rend(); ++it) {
+            int succ = *it;
+            // cost of succ is final here, push it to its predecessors:
+            // cost(t, p) = max over succ of min(row[p], min over w of row[w] + transfer)
+            scheduler.exec_model.times(succ, std::max(1e-3, workflow.tasks[succ].weight), exec_time.data());
+            view.durations(0, exec_time.data(), row.data());
+            simd::add(0, cost(succ), row.data(), row.data(), n);
+            double best = simd::min_of_max(-ResourceView::INF, row.data(), n);
+            for (auto [pred, w] : workflow.dependency_graph[succ]) {
+                double remote = best + w / settings.net_speed;
+                if (settings.optimize_transfers) {
+                    simd::max_of_min(cost(pred), row.data(), remote, n);
+                } else {
+                    double *pred_cost = cost(pred);
+                    for (int p = 0; p < n; ++p)
+                        pred_cost[p] = std::max(pred_cost[p], remote);
+                }
+            }
+        }
+    }
+
+    double *cost(int task) {
+        return table.data() + (size_t)task * n;
+    }
+
+    const double *cost(int task) const {
+        return table.data() + (size_t)task * n;
+    }
+
+    double cost(int task, int res) const {
+        return table[(size_t)task * n + res];
+    }
+
+    // mean of the row, the PEFT rank of the task
+    double mean(int task) const {
+        const double *row = cost(task);
+        double sum = 0;
+        for (int p = 0; p < n; ++p)
+            sum += row[p];
+        return sum / n;
+    }
+
+    int n = 0;
+    std::vector<double> table;  // table[task * n + res]
+};
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef SIMULATOR_REPLAN_POLICY_HPP_
+#define SIMULATOR_REPLAN_POLICY_HPP_
+
+#include "../event.hpp"
+
+// decides on which events the adaptive scheduler rebuilds its plan,
+// between replans it keeps dispatching tasks from the old one
+struct ReplanPolicy {
+    const static int POLICY_EVERY_EVENT = 0;
+    const static int POLICY_EVERY_K     = 1;  // every k-th event
+    const static int POLICY_INTERVAL    = 2;  // first event after interval of simulated time since the last replan
+    const static int POLICY_DEVIATION   = 3;  // task finished with |actual - estimated| > deviation * estimated duration
+    const static int POLICY_FAILURES    = 4;  // task or resource failures only
+
+    ReplanPolicy(int type = POLICY_EVERY_EVENT) : type(type) {}
+
+    // deviation is the relative error of the finished task runtime estimate, 0 for other events
+    bool should_replan(const Event &event, double time, double deviation) {
+        ++events;
+        // tasks planned on a removed resource would never run
+        if (event.event_type == Event::EVENT_RESOURCE_REMOVED)
+            return true;
+        if (type == POLICY_EVERY_K)
+            return events >= k;
+        if (type == POLICY_INTERVAL)
+            return time - last_replan >= interval;
+        if (type == POLICY_DEVIATION)
+            return deviation > this->deviation;
+        if (type == POLICY_FAILURES)
+            return event.event_type == Event::EVENT_TASK_FAILED || event.event_type == Event::EVENT_RESOURCE_DOWN;
+        return true;
+    }
+
+    void replanned(double time) {
+        events = 0;
+        last_replan = time;
+    }
+
+    int type;
+    int k = 1;
+    double interval = 0;
+    double deviation = 0;
+
+    int events = 0;
+    double last_replan = 0;
+};
+
+#endif
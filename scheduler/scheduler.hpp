@@ -2,28 +2,98 @@
 #define SIMULATOR_SCHEDULER_HPP_
 
 #include "../action.hpp"
+#include "../checkpoint.hpp"
+#include "../execution_model.hpp"
 #include "../settings.hpp"
 #include "../workflow.hpp"
 
+#include <set>
+#include <utility>
+
 struct Scheduler {
-    bool dependencies_done(size_t task) {
-        for (auto [j, w] : workflow.dependency_graph[task]) {
-            if (!completed[j]) {
-                return false;
-            }
+    // counts not completed predecessors of every task, ready keeps tasks which are not completed
+    // and have none left. derived schedulers call it in init instead of filling completed
+    void init_ready() {
+        completed.assign(workflow.tasks.size(), false);
+        remaining_predecessors.assign(workflow.tasks.size(), 0);
+        successors.assign(workflow.tasks.size(), {});
+        ready.clear();
+        for (size_t i = 0; i < workflow.tasks.size(); ++i) {
+            remaining_predecessors[i] = workflow.dependency_graph[i].size();
+            for (auto [j, w] : workflow.dependency_graph[i])
+                successors[j].push_back(i);
+        }
+        for (size_t i = 0; i < workflow.tasks.size(); ++i) {
+            if (remaining_predecessors[i] == 0)
+                ready.insert(i);
+        }
+    }
+
+    // O(out-degree) instead of checking predecessors of every task again
+    void complete_task(int task) {
+        if (completed[task])
+            return;
+        completed[task] = true;
+        ready.erase(task);
+        for (int succ : successors[task]) {
+            if (--remaining_predecessors[succ] == 0)
+                ready.insert(succ);
         }
-        return true;
+    }
+
+    bool dependencies_done(size_t task) const {
+        return remaining_predecessors[task] == 0;
     }
 
     virtual std::vector<Action> init(const Settings &) { return {}; }
 
+    // a task may be sent again while it runs: the first attempt to finish gives EVENT_TASK_FINISHED,
+    // then every other one gives EVENT_TASK_CANCELLED with its resource, its slot is already free
     virtual std::vector<Action> notify(const Event &) { return {}; }
 
+    // ask for a new resource, it is appended to resources (down) and comes up
+    // after settings.provisioning_lag with EVENT_RESOURCE_ADDED
+    void request_resource(Resource resource) {
+        resource_requests.push_back(std::move(resource));
+    }
+
+    // give a resource back, tasks running on it fail and EVENT_RESOURCE_REMOVED is sent
+    void release_resource(int resource) {
+        resource_releases.push_back(resource);
+    }
+
+    // ask to be notified with EVENT_SCHEDULER_WAKEUP at the given time
+    void wake_up(double time, int resource) {
+        wakeups.emplace_back(time, resource);
+    }
+
+    // compute time between checkpoints of the task sent to the resource without Action::checkpoint_interval,
+    // 0 for none. the Young and Daly policies need the checkpoint cost of the task and the mtbf of the resource
+    virtual double checkpoint_period(int task, int resource, const Settings &settings) const {
+        double cost = workflow.tasks[task].checkpoint_cost;
+        double mtbf = resources[resource].mtbf;
+        if (settings.checkpoint_policy == Settings::CHECKPOINT_TASK || cost <= 0 || mtbf <= 0)
+            return workflow.tasks[task].checkpoint_interval;
+        if (settings.checkpoint_policy == Settings::CHECKPOINT_YOUNG)
+            return checkpoint::young_period(cost, mtbf);
+        return checkpoint::daly_period(cost, mtbf);
+    }
+
+    virtual void print_stats() const {}
+
     virtual ~Scheduler() {}
 
     Workflow workflow;
     std::vector<bool> completed;
+    std::vector<int> remaining_predecessors;
+    std::vector<std::vector<int>> successors;
+    std::set<int> ready;
     std::vector<Resource> resources;
+    ExecutionModel exec_model;
+
+    std::vector<Resource> resource_requests;
+    std::vector<int> resource_releases;
+    std::vector<std::pair<double, int>> wakeups;
 };
 
 #endif
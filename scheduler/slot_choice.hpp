@@ -0,0 +1,42 @@
+#ifndef SIMULATOR_SLOT_CHOICE_HPP_
+#define SIMULATOR_SLOT_CHOICE_HPP_
+
+#include <limits>
+#include <utility>
+
+// best candidate of HEFT processor selection: the earliest start, ties go to the smaller (resource, slot)
+struct SlotChoice {
+    bool better(double start, int res, int slot) const {
+        return est == -1 || est > start || (est == start && std::make_pair(res, slot) < std::make_pair(this->res, this->slot));
+    }
+
+    // a candidate which can't start before lower_bound can't be better,
+    // neither it can if some other candidate is known to start before upper_bound
+    bool dominates(double lower_bound, int res, int slot) const {
+        return lower_bound > upper_bound || !better(lower_bound, res, slot);
+    }
+
+    void update(double start, int res, int slot) {
+        if (better(start, res, slot)) {
+            est = start;
+            this->res = res;
+            this->slot = slot;
+        }
+    }
+
+    void merge(const SlotChoice &other) {
+        if (other.res != -1)
+            update(other.est, other.res, other.slot);
+        evaluated += other.evaluated;
+        pruned += other.pruned;
+    }
+
+    int res = -1;
+    int slot = -1;
+    double est = -1;
+    double upper_bound = std::numeric_limits<double>::infinity();
+    long long evaluated = 0;
+    long long pruned = 0;
+};
+
+#endif
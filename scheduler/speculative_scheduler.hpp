@@ -0,0 +1,246 @@
+#ifndef SIMULATOR_SPECULATIVE_SCHEDULER_HPP_
+#define SIMULATOR_SPECULATIVE_SCHEDULER_HPP_
+
+#include "scheduler.hpp"
+#include "../action.hpp"
+#include "../resource_index.hpp"
+#include "../workflow.hpp"
+
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <queue>
+#include <set>
+
+// MapReduce style speculative execution: ready tasks go in FIFO order to the first free slot, as in greedy.
+// when no task waits and slots are still free, a backup copy of a straggler is sent to another resource,
+// the first copy to finish wins and the simulator cancels the other one.
+// a running task is a straggler when it has run more than slow_task_threshold times its expected duration
+// and has no backup yet, the most lagging one goes first. the backup goes to the free resource where it is
+// expected to finish first, skipping resources that have been as slow as the straggler so far (LATE).
+// slowness of a resource is learned from finished attempts, as actual / expected duration.
+// straggler candidates are found with a heap of threshold times and wake-ups, not by scanning running tasks
+struct SpeculativeScheduler: public Scheduler {
+    constexpr static double INF = std::numeric_limits<double>::infinity();
+
+    struct Attempt {
+        int res = -1;
+        double start = 0;
+        double expected = 0;
+        bool backup = false;
+    };
+
+    std::vector<Action> init(const Settings &settings) override {
+        this->settings = settings;
+        init_ready();
+        scheduled.assign(workflow.tasks.size(), false);
+        attempts.assign(workflow.tasks.size(), {});
+        task_res.assign(workflow.tasks.size(), -1);
+        exec_model.build(workflow, resources);
+        grow();
+        free_index.build(resources);
+        std::vector<Action> actions;
+        assign_available(actions);
+        return actions;
+    }
+
+    // per resource state for resources added after init
+    void grow() {
+        for (size_t res = tasks_on_res.size(); res < resources.size(); ++res) {
+            if ((int)res >= exec_model.n)
+                exec_model.add_resource(workflow, resources[res]);
+            total_slots += resources[res].slots;
+        }
+        tasks_on_res.resize(resources.size());
+        actual_sum.resize(resources.size(), 0);
+        expected_sum.resize(resources.size(), 0);
+    }
+
+    double rate(int res) const {
+        return expected_sum[res] > 0 ? actual_sum[res] / expected_sum[res] : 1;
+    }
+
+    double expected_time(int task, int res) const {
+        double transfer = 0;
+        for (auto [pred, w] : workflow.dependency_graph[task]) {
+            if (settings.optimize_transfers && task_res[pred] == res) continue;
+            transfer = std::max(transfer, w / settings.net_speed);
+        }
+        return transfer + exec_model.time(task, res, std::max(1e-3, workflow.tasks[task].weight)) + resources[res].delay * 0.55;
+    }
+
+    void start(int task, int res, bool backup, std::vector<Action> &actions) {
+        Attempt attempt;
+        attempt.res = res;
+        attempt.start = current_time;
+        attempt.expected = expected_time(task, res);
+        attempt.backup = backup;
+        attempts[task].push_back(attempt);
+        ++resources[res].used_slots;
+        free_index.update(res, resources[res]);
+        tasks_on_res[res].insert(task);
+        watch.emplace(current_time + slow_task_threshold * attempt.expected, task);
+        actions.emplace_back(task, res);
+    }
+
+    // removes the attempt of the task on the resource if there is one
+    void stop(int task, int res) {
+        auto &list = attempts[task];
+        for (size_t i = 0; i < list.size(); ++i) {
+            if (list[i].res == res) {
+                backups -= list[i].backup;
+                list[i] = list.back();
+                list.pop_back();
+                --resources[res].used_slots;
+                tasks_on_res[res].erase(task);
+                return;
+            }
+        }
+    }
+
+    // a straggler has one attempt which has run past its threshold
+    void check_candidate(int task) {
+        const auto &list = attempts[task];
+        if (!completed[task] && list.size() == 1 && list[0].start + slow_task_threshold * list[0].expected <= current_time)
+            candidates.insert(task);
+        else
+            candidates.erase(task);
+    }
+
+    void assign_available(std::vector<Action> &actions) {
+        for (int task : ready) {
+            if (free_index.total_free() == 0)
+                break;
+            if (!scheduled[task]) {
+                scheduled[task] = true;
+                start(task, free_index.first_free(), false, actions);
+            }
+        }
+    }
+
+    void speculate(std::vector<Action> &actions) {
+        std::vector<int> skipped;
+        while (free_index.total_free() > 0 && backups < speculative_cap * total_slots && !candidates.empty()) {
+            int task = -1;
+            double lag = 0;
+            for (int t : candidates) {
+                const auto &attempt = attempts[t][0];
+                double l = (current_time - attempt.start) / attempt.expected;
+                if (task == -1 || l > lag) {
+                    task = t;
+                    lag = l;
+                }
+            }
+            candidates.erase(task);
+            int original = attempts[task][0].res;
+            int best = -1;
+            double best_finish = INF;
+            for (size_t res = 0; res < resources.size(); ++res) {
+                if ((int)res == original || !resources[res].is_up || resources[res].used_slots >= resources[res].slots || rate(res) >= lag)
+                    continue;
+                double finish = expected_time(task, res) * rate(res);
+                if (finish < best_finish) {
+                    best = res;
+                    best_finish = finish;
+                }
+            }
+            if (best == -1) {
+                // may get a backup when a faster resource is free
+                skipped.push_back(task);
+                continue;
+            }
+            ++backups;
+            ++backups_started;
+            start(task, best, true, actions);
+        }
+        for (int task : skipped)
+            candidates.insert(task);
+    }
+
+    std::vector<Action> notify(const Event &event) override {
+        current_time = event.time;
+        int res = event.resource_id;
+        if (event.event_type == Event::EVENT_TASK_FINISHED) {
+            for (const auto &attempt : attempts[event.task_id]) {
+                if (attempt.res == res) {
+                    actual_sum[res] += current_time - attempt.start;
+                    expected_sum[res] += attempt.expected;
+                    backups_won += attempt.backup;
+                }
+            }
+            complete_task(event.task_id);
+            stop(event.task_id, res);
+            task_res[event.task_id] = res;
+            check_candidate(event.task_id);
+        } else if (event.event_type == Event::EVENT_TASK_CANCELLED) {
+            stop(event.task_id, res);
+        } else if (event.event_type == Event::EVENT_TASK_FAILED) {
+            stop(event.task_id, res);
+            scheduled[event.task_id] = !attempts[event.task_id].empty();
+            check_candidate(event.task_id);
+        } else if (event.event_type == Event::EVENT_RESOURCE_DOWN || event.event_type == Event::EVENT_RESOURCE_REMOVED) {
+            resources[res].is_up = false;
+            resources[res].removed |= event.event_type == Event::EVENT_RESOURCE_REMOVED;
+            std::set<int> lost;
+            lost.swap(tasks_on_res[res]);
+            for (int task : lost) {
+                stop(task, res);
+                scheduled[task] = !attempts[task].empty();
+                check_candidate(task);
+            }
+        } else if (event.event_type == Event::EVENT_RESOURCE_UP || event.event_type == Event::EVENT_RESOURCE_ADDED) {
+            grow();
+            resources[res].is_up = true;
+            resources[res].used_slots = 0;
+        } else if (event.event_type == Event::EVENT_SCHEDULER_WAKEUP) {
+            if (current_time >= next_wakeup)
+                next_wakeup = INF;
+        }
+        if (res >= 0)
+            free_index.update(res, resources[res]);
+
+        while (!watch.empty() && watch.top().first <= current_time) {
+            check_candidate(watch.top().second);
+            watch.pop();
+        }
+        std::vector<Action> actions;
+        assign_available(actions);
+        speculate(actions);
+        // free slots wait for the next straggler
+        if (free_index.total_free() > 0 && !watch.empty() && watch.top().first < next_wakeup) {
+            next_wakeup = watch.top().first;
+            wake_up(next_wakeup, -1);
+        }
+        return actions;
+    }
+
+    void print_stats() const override {
+        std::cerr << "speculative: " << backups_started << " backups, " << backups_won << " finished first" << std::endl;
+    }
+
+    ~SpeculativeScheduler() {}
+
+    double slow_task_threshold = 1.2;  // a task runs this many times its expected duration before a backup
+    double speculative_cap = 0.1;      // running backups at most, share of all slots
+
+    Settings settings;
+    double current_time = 0;
+    std::vector<bool> scheduled;           // has a running attempt
+    std::vector<std::vector<Attempt>> attempts;
+    std::vector<int> task_res;             // where the task finished
+    std::vector<std::set<int>> tasks_on_res;
+    ResourceIndex free_index;
+    long long total_slots = 0;
+    long long backups = 0;                 // running backup attempts
+
+    std::vector<double> actual_sum;        // durations of attempts finished on every resource
+    std::vector<double> expected_sum;      // and their expected durations
+    std::priority_queue<std::pair<double, int>, std::vector<std::pair<double, int>>, std::greater<std::pair<double, int>>> watch;
+    std::set<int> candidates;              // stragglers without a backup
+    double next_wakeup = INF;
+
+    long long backups_started = 0;
+    long long backups_won = 0;
+};
+
+#endif
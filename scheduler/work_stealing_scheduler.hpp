@@ -0,0 +1,229 @@
+#ifndef SIMULATOR_WORK_STEALING_SCHEDULER_HPP_
+#define SIMULATOR_WORK_STEALING_SCHEDULER_HPP_
+
+#include "scheduler.hpp"
+#include "../action.hpp"
+#include "../workflow.hpp"
+
+#include <deque>
+#include <iostream>
+#include <random>
+
+// work stealing runtime: every resource keeps a deque of ready tasks and runs the newest one first.
+// successors which become ready go to the deque of the resource where the task finished, so with
+// optimize_transfers their input is local. a resource with a free slot and an empty deque steals
+// the oldest task of a random non-empty deque, an attempt takes settings.steal_latency.
+// there are never more attempts in flight than queued tasks, slots left without work wait for new tasks.
+// all operations are O(1) amortized per task
+struct WorkStealingScheduler: public Scheduler {
+    std::vector<Action> init(const Settings &settings) override {
+        this->settings = settings;
+        init_ready();
+        running_pos.assign(workflow.tasks.size(), -1);
+        released.assign(workflow.tasks.size(), false);
+        grow();
+        // entry tasks are dealt round robin over up resources
+        std::vector<int> up;
+        for (size_t i = 0; i < resources.size(); ++i) {
+            if (resources[i].is_up)
+                up.push_back(i);
+        }
+        size_t k = 0;
+        for (int task : ready) {
+            released[task] = true;
+            push(up.empty() ? 0 : up[k++ % up.size()], task);
+        }
+        std::vector<Action> actions;
+        for (int res : up)
+            fill(res, actions);
+        wake_idle(actions);
+        return actions;
+    }
+
+    // per resource state for resources added after init
+    void grow() {
+        size_t n = resources.size();
+        deques.resize(n);
+        victim_pos.resize(n, -1);
+        running.resize(n);
+        stealing.resize(n, 0);
+        stale.resize(n, 0);
+        is_idle.resize(n, false);
+    }
+
+    void push(int res, int task) {
+        deques[res].push_back(task);
+        if (deques[res].size() == 1) {
+            victim_pos[res] = victims.size();
+            victims.push_back(res);
+        }
+        ++queued;
+    }
+
+    int take(int res, bool newest) {
+        int task;
+        if (newest) {
+            task = deques[res].back();
+            deques[res].pop_back();
+        } else {
+            task = deques[res].front();
+            deques[res].pop_front();
+        }
+        if (deques[res].empty()) {
+            victim_pos[victims.back()] = victim_pos[res];
+            victims[victim_pos[res]] = victims.back();
+            victims.pop_back();
+            victim_pos[res] = -1;
+        }
+        --queued;
+        return task;
+    }
+
+    int free_slots(int res) const {
+        return resources[res].is_up ? resources[res].slots - resources[res].used_slots - stealing[res] : 0;
+    }
+
+    void start(int task, int res, std::vector<Action> &actions) {
+        ++resources[res].used_slots;
+        running_pos[task] = running[res].size();
+        running[res].push_back(task);
+        actions.emplace_back(task, res);
+    }
+
+    void stop(int task, int res) {
+        if (running_pos[task] == -1)
+            return;
+        int last = running[res].back();
+        running[res][running_pos[task]] = last;
+        running_pos[last] = running_pos[task];
+        running[res].pop_back();
+        running_pos[task] = -1;
+    }
+
+    void steal(int res, std::vector<Action> &actions) {
+        int victim = victims[rnd() % victims.size()];
+        start(take(victim, false), res, actions);
+        ++steals;
+    }
+
+    // runs local tasks on free slots of the resource, then steals for the rest or leaves them idle
+    void fill(int res, std::vector<Action> &actions) {
+        while (free_slots(res) > 0 && !deques[res].empty()) {
+            start(take(res, true), res, actions);
+            ++local_starts;
+        }
+        while (free_slots(res) > 0 && queued > in_flight) {
+            if (settings.steal_latency > 0) {
+                ++stealing[res];
+                ++in_flight;
+                wake_up(current_time + settings.steal_latency, res);
+            } else {
+                steal(res, actions);
+            }
+        }
+        if (free_slots(res) > 0 && !is_idle[res]) {
+            is_idle[res] = true;
+            idle.push_back(res);
+        }
+    }
+
+    // idle resources go stealing while there are queued tasks nobody is after
+    void wake_idle(std::vector<Action> &actions) {
+        while (!idle.empty() && queued > in_flight) {
+            int res = idle.back();
+            idle.pop_back();
+            is_idle[res] = false;
+            fill(res, actions);
+        }
+    }
+
+    std::vector<Action> notify(const Event &event) override {
+        current_time = event.time;
+        int res = event.resource_id;
+        std::vector<Action> actions;
+        if (event.event_type == Event::EVENT_TASK_FINISHED) {
+            bool done = completed[event.task_id];
+            complete_task(event.task_id);
+            stop(event.task_id, res);
+            --resources[res].used_slots;
+            if (!done) {
+                // a successor may be listed once per dependency
+                for (int succ : successors[event.task_id]) {
+                    if (dependencies_done(succ) && !released[succ]) {
+                        released[succ] = true;
+                        push(res, succ);
+                    }
+                }
+            }
+        } else if (event.event_type == Event::EVENT_TASK_FAILED) {
+            stop(event.task_id, res);
+            --resources[res].used_slots;
+            push(res, event.task_id);
+        } else if (event.event_type == Event::EVENT_RESOURCE_DOWN || event.event_type == Event::EVENT_RESOURCE_REMOVED) {
+            resources[res].is_up = false;
+            resources[res].removed |= event.event_type == Event::EVENT_RESOURCE_REMOVED;
+            // lost tasks stay in the deque of the resource for others to steal
+            for (int task : running[res]) {
+                running_pos[task] = -1;
+                push(res, task);
+            }
+            running[res].clear();
+            stale[res] += stealing[res];
+            in_flight -= stealing[res];
+            stealing[res] = 0;
+        } else if (event.event_type == Event::EVENT_RESOURCE_UP || event.event_type == Event::EVENT_RESOURCE_ADDED) {
+            grow();
+            resources[res].is_up = true;
+            resources[res].used_slots = 0;
+        } else if (event.event_type == Event::EVENT_SCHEDULER_WAKEUP) {
+            // attempts started before the resource went down are dropped
+            if (stale[res] > 0) {
+                --stale[res];
+            } else {
+                --stealing[res];
+                --in_flight;
+                if (!deques[res].empty()) {
+                    start(take(res, true), res, actions);
+                    ++local_starts;
+                } else if (queued > 0) {
+                    steal(res, actions);
+                } else {
+                    ++failed_steals;
+                }
+            }
+        }
+        if (resources[res].is_up)
+            fill(res, actions);
+        wake_idle(actions);
+        return actions;
+    }
+
+    void print_stats() const override {
+        std::cerr << "local starts: " << local_starts << ", steals: " << steals << ", failed steal attempts: " << failed_steals << std::endl;
+    }
+
+    ~WorkStealingScheduler() {}
+
+    Settings settings;
+    double current_time = 0;
+    std::minstd_rand rnd;
+
+    std::vector<std::deque<int>> deques;
+    std::vector<int> victims;     // resources with non-empty deques
+    std::vector<int> victim_pos;  // position in victims, -1 if the deque is empty
+    long long queued = 0;         // tasks in all deques
+    std::vector<std::vector<int>> running;
+    std::vector<int> running_pos;
+    std::vector<int> stealing;    // steal attempts in flight, each holds a slot of the resource
+    std::vector<int> stale;       // attempts to ignore, started before the resource went down
+    long long in_flight = 0;
+    std::vector<bool> released;   // the task got into a deque once, later only after failures
+    std::vector<int> idle;        // resources with free slots and nothing to do, may be outdated
+    std::vector<bool> is_idle;
+
+    long long local_starts = 0;
+    long long steals = 0;
+    long long failed_steals = 0;
+};
+
+#endif
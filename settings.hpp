@@ -2,8 +2,21 @@
 #define SIMULATOR_SETTINGS_HPP_
 
 struct Settings {
+    const static int CHECKPOINT_TASK  = 0;  // checkpoint_interval of the task
+    const static int CHECKPOINT_YOUNG = 1;  // optimum by Young for the checkpoint cost and mtbf of the resource
+    const static int CHECKPOINT_DALY  = 2;  // higher order optimum by Daly
+
     bool optimize_transfers;
     double net_speed;
+    double provisioning_lag = 0;  // time between request of a new resource and its availability
+    bool scheduler_stats = false;  // print scheduler counters at the end
+    // simulated time of every scheduler call: decision_latency + latency_scale * cpu seconds spent in it.
+    // the scheduler is busy meanwhile, its actions apply at the end and new events wait in a queue
+    double decision_latency = 0;
+    double latency_scale = 0;
+    bool wall_clock_latency = false;  // scale wall time of the call instead of cpu time of the simulator thread
+    double steal_latency = 0;  // time of a steal attempt in the work stealing scheduler
+    int checkpoint_policy = CHECKPOINT_TASK;  // default checkpoint period of Scheduler::checkpoint_period
 };
 
 #endif
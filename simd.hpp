@@ -0,0 +1,162 @@
+#ifndef SIMULATOR_SIMD_HPP_
+#define SIMULATOR_SIMD_HPP_
+
+#include <algorithm>
+#include <limits>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SIMULATOR_SIMD_DISPATCH
+#include <immintrin.h>
+#endif
+
+// kernels over contiguous arrays of doubles. AVX-512 or AVX paths are compiled with target attributes and chosen
+// at run time by the cpu, so a plain build without -mavx flags uses them too; scalar elsewhere.
+// every element is computed with the same operations in the same order as the scalar loop, so results are bitwise equal
+namespace simd {
+
+enum Level { SCALAR, AVX, AVX512 };
+
+// widest instruction set supported by the cpu, detected once
+inline Level level() {
+#if defined(SIMULATOR_SIMD_DISPATCH)
+    static const Level detected = __builtin_cpu_supports("avx512f") ? AVX512 : __builtin_cpu_supports("avx") ? AVX : SCALAR;
+    return detected;
+#else
+    return SCALAR;
+#endif
+}
+
+// vector parts of the kernels, each returns the number of elements done and leaves the tail to the scalar loop
+#if defined(SIMULATOR_SIMD_DISPATCH)
+namespace detail {
+
+__attribute__((target("avx512f"))) inline int add_avx512(double a, const double *x, const double *y, double *out, int n) {
+    int i = 0;
+    __m512d va = _mm512_set1_pd(a);
+    for (; i + 8 <= n; i += 8)
+        _mm512_storeu_pd(out + i, _mm512_add_pd(_mm512_add_pd(va, _mm512_loadu_pd(x + i)), _mm512_loadu_pd(y + i)));
+    return i;
+}
+
+__attribute__((target("avx"))) inline int add_avx(double a, const double *x, const double *y, double *out, int n) {
+    int i = 0;
+    __m256d va = _mm256_set1_pd(a);
+    for (; i + 4 <= n; i += 4)
+        _mm256_storeu_pd(out + i, _mm256_add_pd(_mm256_add_pd(va, _mm256_loadu_pd(x + i)), _mm256_loadu_pd(y + i)));
+    return i;
+}
+
+__attribute__((target("avx512f"))) inline int div_avx512(double a, const double *x, double *out, int n) {
+    int i = 0;
+    __m512d va = _mm512_set1_pd(a);
+    for (; i + 8 <= n; i += 8)
+        _mm512_storeu_pd(out + i, _mm512_div_pd(va, _mm512_loadu_pd(x + i)));
+    return i;
+}
+
+__attribute__((target("avx"))) inline int div_avx(double a, const double *x, double *out, int n) {
+    int i = 0;
+    __m256d va = _mm256_set1_pd(a);
+    for (; i + 4 <= n; i += 4)
+        _mm256_storeu_pd(out + i, _mm256_div_pd(va, _mm256_loadu_pd(x + i)));
+    return i;
+}
+
+__attribute__((target("avx512f"))) inline int min_of_max_avx512(double a, const double *x, int n, double &res) {
+    int i = 0;
+    __m512d va = _mm512_set1_pd(a);
+    __m512d vres = _mm512_set1_pd(res);
+    for (; i + 8 <= n; i += 8)
+        vres = _mm512_min_pd(vres, _mm512_max_pd(va, _mm512_loadu_pd(x + i)));
+    res = _mm512_reduce_min_pd(vres);
+    return i;
+}
+
+__attribute__((target("avx"))) inline int min_of_max_avx(double a, const double *x, int n, double &res) {
+    int i = 0;
+    __m256d va = _mm256_set1_pd(a);
+    __m256d vres = _mm256_set1_pd(res);
+    for (; i + 4 <= n; i += 4)
+        vres = _mm256_min_pd(vres, _mm256_max_pd(va, _mm256_loadu_pd(x + i)));
+    alignas(32) double lanes[4];
+    _mm256_store_pd(lanes, vres);
+    res = std::min({lanes[0], lanes[1], lanes[2], lanes[3]});
+    return i;
+}
+
+__attribute__((target("avx512f"))) inline int max_of_min_avx512(double *out, const double *x, double a, int n) {
+    int i = 0;
+    __m512d va = _mm512_set1_pd(a);
+    for (; i + 8 <= n; i += 8)
+        _mm512_storeu_pd(out + i, _mm512_max_pd(_mm512_loadu_pd(out + i), _mm512_min_pd(_mm512_loadu_pd(x + i), va)));
+    return i;
+}
+
+__attribute__((target("avx"))) inline int max_of_min_avx(double *out, const double *x, double a, int n) {
+    int i = 0;
+    __m256d va = _mm256_set1_pd(a);
+    for (; i + 4 <= n; i += 4)
+        _mm256_storeu_pd(out + i, _mm256_max_pd(_mm256_loadu_pd(out + i), _mm256_min_pd(_mm256_loadu_pd(x + i), va)));
+    return i;
+}
+
+}
+#endif
+
+// out[i] = (a + x[i]) + y[i]
+inline void add(double a, const double *x, const double *y, double *out, int n) {
+    int i = 0;
+#if defined(SIMULATOR_SIMD_DISPATCH)
+    if (level() == AVX512)
+        i = detail::add_avx512(a, x, y, out, n);
+    else if (level() == AVX)
+        i = detail::add_avx(a, x, y, out, n);
+#endif
+    for (; i < n; ++i)
+        out[i] = a + x[i] + y[i];
+}
+
+// out[i] = a / x[i]
+inline void div(double a, const double *x, double *out, int n) {
+    int i = 0;
+#if defined(SIMULATOR_SIMD_DISPATCH)
+    if (level() == AVX512)
+        i = detail::div_avx512(a, x, out, n);
+    else if (level() == AVX)
+        i = detail::div_avx(a, x, out, n);
+#endif
+    for (; i < n; ++i)
+        out[i] = a / x[i];
+}
+
+// min over i of max(a, x[i]), infinity for n = 0
+inline double min_of_max(double a, const double *x, int n) {
+    double res = std::numeric_limits<double>::infinity();
+    int i = 0;
+#if defined(SIMULATOR_SIMD_DISPATCH)
+    if (level() == AVX512)
+        i = detail::min_of_max_avx512(a, x, n, res);
+    else if (level() == AVX)
+        i = detail::min_of_max_avx(a, x, n, res);
+#endif
+    for (; i < n; ++i)
+        res = std::min(res, std::max(a, x[i]));
+    return res;
+}
+
+// out[i] = max(out[i], min(x[i], a))
+inline void max_of_min(double *out, const double *x, double a, int n) {
+    int i = 0;
+#if defined(SIMULATOR_SIMD_DISPATCH)
+    if (level() == AVX512)
+        i = detail::max_of_min_avx512(out, x, a, n);
+    else if (level() == AVX)
+        i = detail::max_of_min_avx(out, x, a, n);
+#endif
+    for (; i < n; ++i)
+        out[i] = std::max(out[i], std::min(x[i], a));
+}
+
+}
+
+#endif
@@ -1,23 +1,47 @@
 #ifndef SIMULATOR_SIMULATOR_HPP_
 #define SIMULATOR_SIMULATOR_HPP_
 
+#include <algorithm>
+#include <chrono>
+#include <ctime>
 #include <iomanip>
 #include <iostream>
+#include <limits>
 #include <numeric>
 #include <queue>
 #include <random>
 #include <set>
+#include <tuple>
+#include <unordered_set>
 #include <vector>
 #include <memory>
 
 #include "event.hpp"
+#include "execution_model.hpp"
+#include "failure_model.hpp"
 #include "resource.hpp"
 #include "scheduler/scheduler.hpp"
 #include "settings.hpp"
 #include "task.hpp"
+#include "trace_source.hpp"
 #include "workflow.hpp"
 
 struct Simulator {
+    // one run of a task on a slot. with checkpoints it reads the last checkpoint of the task for cost,
+    // then writes one after every period of compute for cost, except at the end
+    struct Attempt {
+        int id = -1;              // of its events
+        int resource = -1;
+        int slot = -1;
+        double started = 0;       // end of the queue delay
+        double restart = 0;       // time to read the checkpoint, 0 if the task starts from scratch
+        double period = 0;        // compute time between checkpoints, 0 without checkpoints
+        double cost = 0;
+        double base = 0;          // share of the task done before the attempt
+        double step = 0;          // share of the task done in one period
+        int checkpoints = 0;      // written till the attempt ends
+    };
+
     void add_resource(Resource resource) {
         resource.id = resources.size();
         resources.push_back(std::move(resource));
@@ -35,6 +59,83 @@ struct Simulator {
         resource_queues[resource].emplace_back(start_time, start_time + duration, factor);
     }
 
+    void set_failure_model(int resource, FailureModel model) {
+        if (failure_models.size() < resources.size())
+            failure_models.resize(resources.size());
+        model.enabled = true;
+        failure_models[resource] = model;
+        resources[resource].mtbf = model.time_to_failure.mean();
+    }
+
+    void push_model_event(int resource, int event_type, double time) {
+        Event e;
+        e.time = time;
+        e.event_type = event_type;
+        e.resource_id = resource;
+        e.from_model = true;
+        events.push(e);
+    }
+
+    // samples the next interval of the failure model when the current one ends,
+    // returns false if the event has to be skipped because the workflow is done or the resource is removed.
+    // no failure starts after model_horizon, so a model that keeps the workflow from completing still ends
+    bool advance_failure_model(const Event &e) {
+        const auto &model = failure_models[e.resource_id];
+        const auto &resource = resources[e.resource_id];
+        // failures go on forever, stop when the workflow is done
+        if (resource.removed || completed_count == (int)workflow.tasks.size())
+            return false;
+        if (e.event_type == Event::EVENT_RESOURCE_DOWN) {
+            push_model_event(e.resource_id, Event::EVENT_RESOURCE_UP, current_time + model.repair_time.sample(rnd));
+        } else {
+            double next = current_time + model.time_to_failure.sample(rnd);
+            if (next <= model_horizon)
+                push_model_event(e.resource_id, Event::EVENT_RESOURCE_DOWN, next);
+        }
+        return true;
+    }
+
+    // pushes the start of the next interval of a trace, its end is pushed when the start is processed,
+    // so only one interval per trace and one active interval per resource are kept in events
+    void push_next_trace_event(TraceSource &trace, int event_type) {
+        if (!trace.next())
+            return;
+        if (trace.resource < 0 || trace.resource >= (int)resources.size()) {
+            std::cerr << "wrong resource " << trace.resource << " in trace " << trace.file << std::endl;
+            exit(1);
+        }
+        Event e;
+        e.time = trace.start;
+        e.event_type = event_type;
+        e.resource_id = trace.resource;
+        e.factor = trace.factor;
+        e.from_trace = true;
+        events.push(e);
+    }
+
+    // pushes the end of the interval started by a trace event and the start of the next one,
+    // returns false if the event has to be skipped because the workflow is done
+    bool advance_trace(const Event &start) {
+        // traces may be longer than the run, stop reading them when the workflow is done
+        if (completed_count == (int)workflow.tasks.size())
+            return false;
+        Event e;
+        e.resource_id = start.resource_id;
+        if (start.event_type == Event::EVENT_RESOURCE_DOWN) {
+            e.time = failure_trace.end;
+            e.event_type = Event::EVENT_RESOURCE_UP;
+            events.push(e);
+            push_next_trace_event(failure_trace, Event::EVENT_RESOURCE_DOWN);
+        } else if (start.event_type == Event::EVENT_RESOURCE_DELAY) {
+            e.time = queue_trace.end;
+            e.event_type = Event::EVENT_RESOURCE_DELAY;
+            e.factor = 1 / start.factor;
+            events.push(e);
+            push_next_trace_event(queue_trace, Event::EVENT_RESOURCE_DELAY);
+        }
+        return true;
+    }
+
     void make_action(const Action &action) {
         if (action.resource_id < 0 || action.resource_id >= (int)resources.size()) {
             std::cerr << "wrong action resource_id" << std::endl;
@@ -60,11 +161,9 @@ struct Simulator {
             exit(1);
         }
 
-        for (auto [j, w] : workflow.dependency_graph[action.task_id]) {
-            if (!completed[j]) {
-                std::cerr << "wrong action: not all required tasks completed before task " << action.task_id << std::endl;
-                exit(1);
-            }
+        if (remaining_predecessors[action.task_id] != 0) {
+            std::cerr << "wrong action: not all required tasks completed before task " << action.task_id << std::endl;
+            exit(1);
         }
 
         Event e;
@@ -93,42 +192,272 @@ struct Simulator {
 
         events.push(e);
 
+        // the attempt goes on from the last checkpoint of the task
+        Attempt attempt;
+        attempt.id = e.id;
+        attempt.resource = e.resource_id;
+        attempt.slot = e.slot;
+        attempt.started = e.time;
+        attempt.base = progress[e.task_id];
+        attempt.cost = workflow.tasks[e.task_id].checkpoint_cost;
+        attempt.restart = attempt.base > 0 ? attempt.cost : 0;
+        attempt.period = action.checkpoint_interval >= 0 ? action.checkpoint_interval : scheduler->checkpoint_period(e.task_id, e.resource_id, settings);
+        checkpoint_restarts += attempt.base > 0;
+
+        double exec = exec_model.time(action.task_id, action.resource_id, workflow.tasks[action.task_id].weight) * resources[action.resource_id].straggler_factor;
+        double work;  // compute time of the whole task in this attempt
+        double run;   // compute time till the attempt ends
         // fail task
         if (with_prob(fail_prob)) {
-            // fail at random time from 0 to 1.1 * estimated task time
-            e.time += workflow.tasks[action.task_id].weight / resources[action.resource_id].speed * resources[action.resource_id].straggler_factor * ud(rnd);
+            // fail at random time from 0 to 1.1 * estimated time of the rest of the task
+            work = exec;
+            run = (1 - attempt.base) * exec * ud(rnd);
             e.event_type = Event::EVENT_TASK_FAILED;
-
-            events.push(e);
         } else {
             // normal distibution with mean = estimated time and standard deviation = 10%
-            e.time += workflow.tasks[action.task_id].weight / resources[action.resource_id].speed * resources[action.resource_id].straggler_factor * nd(rnd);
+            work = exec * nd(rnd);
+            run = (1 - attempt.base) * work;
             e.event_type = Event::EVENT_TASK_FINISHED;
-
-            events.push(e);
         }
+        if (attempt.period > 0) {
+            attempt.step = attempt.period / work;
+            attempt.checkpoints = std::max(0.0, std::ceil(run / attempt.period) - 1);
+        }
+        e.time += attempt.restart + run + attempt.checkpoints * attempt.cost;
+        events.push(e);
+
+        // the task may already be running elsewhere, the first attempt to finish wins
+        if (!task_attempts[e.task_id].empty())
+            ++backup_attempts;
+        task_attempts[e.task_id].push_back(attempt);
 
         resources[action.resource_id].used_slots++;
     }
 
+    // checkpoints the attempt has written by now are kept for the next attempts of the task
+    void save_progress(int task, const Attempt &attempt) {
+        if (attempt.period <= 0)
+            return;
+        int done = std::min<double>(attempt.checkpoints, std::floor((current_time - attempt.started - attempt.restart) / (attempt.period + attempt.cost)));
+        if (done <= 0)
+            return;
+        checkpoints_written += done;
+        progress[task] = std::max(progress[task], std::min(1.0, attempt.base + done * attempt.step));
+    }
+
+    // the attempt is over, finished, failed or lost
+    void end_attempt(int task, int id) {
+        auto &attempts = task_attempts[task];
+        for (size_t i = 0; i < attempts.size(); ++i) {
+            if (attempts[i].id == id) {
+                save_progress(task, attempts[i]);
+                attempts[i] = attempts.back();
+                attempts.pop_back();
+                return;
+            }
+        }
+    }
+
+    // stops the other attempts of a finished task and frees their slots. their events stay in the queue
+    // and are skipped by id, so a cancellation costs O(1) whatever the number of events in flight
+    std::vector<Event> cancel_attempts(int task) {
+        std::vector<Event> cancelled;
+        for (const auto &attempt : task_attempts[task]) {
+            if (logging) {
+                std::cout << "time " << std::setw(6) << current_time << ": task " << task << " cancelled on " << attempt.resource << " slot " << attempt.slot << std::endl;
+            }
+            save_progress(task, attempt);
+            failed_ids.insert(attempt.id);
+            resource_tasks[attempt.resource].erase({attempt.id, task});
+            resources[attempt.resource].used_slots--;
+            resources[attempt.resource].return_slot(attempt.slot);
+            ++cancelled_attempts;
+            Event e;
+            e.time = current_time;
+            e.event_type = Event::EVENT_TASK_CANCELLED;
+            e.task_id = task;
+            e.resource_id = attempt.resource;
+            e.slot = attempt.slot;
+            cancelled.push_back(e);
+        }
+        task_attempts[task].clear();
+        return cancelled;
+    }
+
+    // attempts running on a resource which went down or was removed are lost without events
+    void lose_attempts(int resource) {
+        for (auto [id, task] : resource_tasks[resource]) {
+            failed_ids.insert(id);
+            end_attempt(task, id);
+        }
+        resource_tasks[resource].clear();
+    }
+
+    // cpu time of the simulator thread only, thread pool workers and the background planner are not counted
+    static double thread_cpu_time() {
+        timespec ts;
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+        return ts.tv_sec + ts.tv_nsec * 1e-9;
+    }
+
+    static double wall_time() {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // passes the event to the scheduler, measuring cpu and wall time spent in it
+    std::vector<Action> notify_scheduler(const Event &e) {
+        double cpu_start = thread_cpu_time();
+        double wall_start = wall_time();
+        auto actions = scheduler->notify(e);
+        last_call_time = call_time(cpu_start, wall_start);
+        ++scheduler_calls;
+        return actions;
+    }
+
+    // adds the call to the totals, returns its cost for the decision latency
+    double call_time(double cpu_start, double wall_start) {
+        double cpu = thread_cpu_time() - cpu_start;
+        double wall = wall_time() - wall_start;
+        scheduler_time += cpu;
+        scheduler_wall_time += wall;
+        return settings.wall_clock_latency ? wall : cpu;
+    }
+
+    bool with_latency() const {
+        return settings.decision_latency > 0 || settings.latency_scale > 0;
+    }
+
+    void call_scheduler(const Event &e) {
+        if (!with_latency()) {
+            make_scheduler_actions(notify_scheduler(e));
+            return;
+        }
+        if (e.event_type == Event::EVENT_RESOURCE_DOWN || e.event_type == Event::EVENT_RESOURCE_REMOVED)
+            ++resource_downs[e.resource_id];
+        pending_notifications.push(e);
+        if (!scheduler_busy)
+            next_decision();
+    }
+
+    void next_decision() {
+        Event e = pending_notifications.front();
+        pending_notifications.pop();
+        if (e.event_type == Event::EVENT_RESOURCE_DOWN || e.event_type == Event::EVENT_RESOURCE_REMOVED)
+            ++notified_downs[e.resource_id];
+        auto actions = notify_scheduler(e);
+        start_decision(actions, last_call_time);
+    }
+
+    void start_decision(const std::vector<Action> &actions, double call_seconds) {
+        double latency = settings.decision_latency + settings.latency_scale * call_seconds;
+        scheduler_busy_time += latency;
+        pending_actions = actions;
+        scheduler_busy = true;
+        Event e;
+        e.time = current_time + latency;
+        e.event_type = Event::EVENT_SCHEDULER_DONE;
+        events.push(e);
+    }
+
     void make_scheduler_actions(const std::vector<Action> &actions) {
         for (const auto &action : actions) {
             make_action(action);
         }
+        make_resource_requests();
+        make_wakeups();
+    }
+
+    // wake-ups asked for during a decision with latency may already be in the past
+    void make_wakeups() {
+        for (auto [time, resource] : scheduler->wakeups) {
+            Event e;
+            e.time = std::max(current_time, time);
+            e.event_type = Event::EVENT_SCHEDULER_WAKEUP;
+            e.resource_id = resource;
+            events.push(e);
+        }
+        scheduler->wakeups.clear();
+    }
+
+    // new resources are registered right away (down) so that ids stay in sync with the scheduler,
+    // and come up after provisioning lag
+    void make_resource_requests() {
+        for (auto &resource : scheduler->resource_requests) {
+            resource.is_up = false;
+            resource.removed = false;
+            resource.used_slots = 0;
+            add_resource(resource);
+            scheduler->resources.push_back(resources.back());
+            exec_model.add_resource(workflow, resources.back());
+            resource_tasks.emplace_back();
+            resource_failures.emplace_back();
+            resource_queues.emplace_back();
+            failure_models.emplace_back();
+            resource_downs.push_back(0);
+            notified_downs.push_back(0);
+            down_sources.push_back(0);
+
+            Event e;
+            e.time = current_time + settings.provisioning_lag;
+            e.event_type = Event::EVENT_RESOURCE_ADDED;
+            e.resource_id = resources.back().id;
+            events.push(e);
+        }
+        scheduler->resource_requests.clear();
+
+        for (int resource : scheduler->resource_releases) {
+            if (resource < 0 || resource >= (int)resources.size()) {
+                std::cerr << "wrong release: resource " << resource << " does not exist" << std::endl;
+                exit(1);
+            }
+            Event e;
+            e.time = current_time;
+            e.event_type = Event::EVENT_RESOURCE_REMOVED;
+            e.resource_id = resource;
+            events.push(e);
+        }
+        scheduler->resource_releases.clear();
     }
 
     void run() {
         workflow.check_correctness();
+        for (const auto &resource : resources) {
+            if (!workflow.type_speeds.empty() && (resource.type < 0 || resource.type >= (int)workflow.type_speeds[0].size())) {
+                std::cerr << "wrong resource type " << resource.type << std::endl;
+                exit(1);
+            }
+        }
+        exec_model.build(workflow, resources);
         scheduler->workflow = workflow;
         scheduler->resources = resources;
         completed.assign(workflow.tasks.size(), false);
+        completed_count = 0;
+        remaining_predecessors.assign(workflow.tasks.size(), 0);
+        successors.assign(workflow.tasks.size(), {});
+        for (size_t i = 0; i < workflow.tasks.size(); ++i) {
+            remaining_predecessors[i] = workflow.dependency_graph[i].size();
+            for (auto [j, w] : workflow.dependency_graph[i])
+                successors[j].push_back(i);
+        }
         completion_time.resize(workflow.tasks.size());
+        task_attempts.assign(workflow.tasks.size(), {});
+        progress.assign(workflow.tasks.size(), 0);
         task_location.resize(workflow.tasks.size());
-        std::vector<std::set<int>> resource_tasks(resources.size());
+        resource_tasks.assign(resources.size(), {});
         resource_failures.resize(resources.size());
         resource_queues.resize(resources.size());
-
-        make_scheduler_actions(scheduler->init(settings));
+        resource_downs.assign(resources.size(), 0);
+        notified_downs.assign(resources.size(), 0);
+        down_sources.assign(resources.size(), 0);
+
+        double cpu_start = thread_cpu_time();
+        double wall_start = wall_time();
+        auto init_actions = scheduler->init(settings);
+        double init_time = call_time(cpu_start, wall_start);
+        if (with_latency())
+            start_decision(init_actions, init_time);
+        else
+            make_scheduler_actions(init_actions);
 
         for (size_t i = 0; i < resources.size(); ++i) {
             for (auto [start, end] : resource_failures[i]) {
@@ -156,6 +485,16 @@ struct Simulator {
                 events.push(e);
             }
         }
+        push_next_trace_event(failure_trace, Event::EVENT_RESOURCE_DOWN);
+        push_next_trace_event(queue_trace, Event::EVENT_RESOURCE_DELAY);
+        failure_models.resize(resources.size());
+        for (size_t i = 0; i < resources.size(); ++i) {
+            if (!failure_models[i].enabled)
+                continue;
+            double next = failure_models[i].time_to_failure.sample(rnd);
+            if (next <= model_horizon)
+                push_model_event(i, Event::EVENT_RESOURCE_DOWN, next);
+        }
 
         if (logging) {
             // print some info for a drawing
@@ -180,7 +519,18 @@ struct Simulator {
             events.pop();
             current_time = e.time;
 
+            if (e.from_trace && !advance_trace(e)) {
+                continue;
+            }
+
+            if (e.from_model && !advance_failure_model(e)) {
+                continue;
+            }
+
             if (failed_ids.count(e.id)) {
+                // the last event of a lost or cancelled attempt, its id is not needed anymore
+                if (e.event_type == Event::EVENT_TASK_FINISHED || e.event_type == Event::EVENT_TASK_FAILED)
+                    failed_ids.erase(e.id);
                 continue;
             }
 
@@ -190,7 +540,7 @@ struct Simulator {
                     std::cout << "time " << std::setw(6) << current_time << ": task " << e.task_id << " arrived on " << e.resource_id << " slot " << e.slot << std::endl;
                 }
                 finish_time = current_time;
-                resource_tasks[e.resource_id].insert(e.id);
+                resource_tasks[e.resource_id].emplace(e.id, e.task_id);
             } else if (e.event_type == Event::EVENT_TASK_LOADED) {
                 if (logging) {
                     std::cout << "time " << std::setw(6) << current_time << ": task " << e.task_id << " loaded on " << e.resource_id << " slot " << e.slot << std::endl;
@@ -206,48 +556,110 @@ struct Simulator {
                     std::cout << "time " << std::setw(6) << current_time << ": task " << e.task_id << " finished on " << e.resource_id << " slot " << e.slot << std::endl;
                 }
                 finish_time = current_time;
-                resource_tasks[e.resource_id].erase(e.id);
+                resource_tasks[e.resource_id].erase({e.id, e.task_id});
                 resources[e.resource_id].used_slots--;
                 completed[e.task_id] = true;
+                ++completed_count;
+                for (int succ : successors[e.task_id])
+                    --remaining_predecessors[succ];
                 completion_time[e.task_id] = e.time;
                 task_location[e.task_id] = e.resource_id;
                 resources[e.resource_id].return_slot(e.slot);
-                make_scheduler_actions(scheduler->notify(e));
+                end_attempt(e.task_id, e.id);
+                auto cancelled = cancel_attempts(e.task_id);
+                call_scheduler(e);
+                for (const auto &c : cancelled)
+                    call_scheduler(c);
             } else if (e.event_type == Event::EVENT_TASK_FAILED) {
                 if (logging) {
                     std::cout << "time " << std::setw(6) << current_time << ": task " << e.task_id << " failed on " << e.resource_id << " slot " << e.slot << std::endl;
                 }
                 finish_time = current_time;
-                resource_tasks[e.resource_id].erase(e.id);
+                resource_tasks[e.resource_id].erase({e.id, e.task_id});
                 resources[e.resource_id].used_slots--;
                 resources[e.resource_id].return_slot(e.slot);
-                make_scheduler_actions(scheduler->notify(e));
+                end_attempt(e.task_id, e.id);
+                call_scheduler(e);
             } else if (e.event_type == Event::EVENT_RESOURCE_DOWN) {
-                if (!resources[e.resource_id].is_up) {
-                    std::cerr << "resource " << e.resource_id << " is already down" << std::endl;
-                    exit(1);
+                if (resources[e.resource_id].removed) {
+                    continue;
+                }
+                if (down_sources[e.resource_id]++ > 0) {
+                    // overlaps a down interval of another source, the resource is up when all of them end
+                    continue;
                 }
                 if (logging) {
                     std::cout << "time " << std::setw(6) << current_time << ": resource " << e.resource_id << " down" << std::endl;
                 }
                 resources[e.resource_id].is_up = false;
-                for (int id : resource_tasks[e.resource_id])
-                    failed_ids.insert(id);
-                make_scheduler_actions(scheduler->notify(e));
+                lose_attempts(e.resource_id);
+                call_scheduler(e);
             } else if (e.event_type == Event::EVENT_RESOURCE_UP) {
-                if (resources[e.resource_id].is_up) {
+                if (resources[e.resource_id].removed) {
+                    continue;
+                }
+                if (down_sources[e.resource_id] == 0) {
                     std::cerr << "resource " << e.resource_id << " is already up" << std::endl;
                     exit(1);
                 }
+                if (--down_sources[e.resource_id] > 0) {
+                    continue;
+                }
                 if (logging) {
                     std::cout << "time " << std::setw(6) << current_time << ": resource " << e.resource_id << " up" << std::endl;
                 }
                 resources[e.resource_id].is_up = true;
                 resources[e.resource_id].used_slots = 0;
                 resources[e.resource_id].fill_slots();
-                make_scheduler_actions(scheduler->notify(e));
+                call_scheduler(e);
             } else if (e.event_type == Event::EVENT_RESOURCE_DELAY) {
                 resources[e.resource_id].delay *= e.factor;
+            } else if (e.event_type == Event::EVENT_RESOURCE_ADDED) {
+                if (resources[e.resource_id].removed) {
+                    continue;
+                }
+                if (logging) {
+                    std::cout << "time " << std::setw(6) << current_time << ": resource " << e.resource_id << " added" << std::endl;
+                }
+                resources[e.resource_id].is_up = true;
+                call_scheduler(e);
+            } else if (e.event_type == Event::EVENT_RESOURCE_REMOVED) {
+                if (resources[e.resource_id].removed) {
+                    continue;
+                }
+                if (logging) {
+                    std::cout << "time " << std::setw(6) << current_time << ": resource " << e.resource_id << " removed" << std::endl;
+                }
+                resources[e.resource_id].is_up = false;
+                resources[e.resource_id].removed = true;
+                lose_attempts(e.resource_id);
+                call_scheduler(e);
+            } else if (e.event_type == Event::EVENT_SCHEDULER_WAKEUP) {
+                call_scheduler(e);
+            } else if (e.event_type == Event::EVENT_SCHEDULER_DONE) {
+                scheduler_busy = false;
+                // the resource failed after the decision was made, the scheduler counts the task as lost
+                // when it learns about the failure, so the task must not start.
+                // a backup of a task which finished meanwhile is cancelled before it starts
+                pending_actions.erase(std::remove_if(pending_actions.begin(), pending_actions.end(), [&](const Action &action) {
+                    if (resource_downs[action.resource_id] != notified_downs[action.resource_id])
+                        return true;
+                    if (!completed[action.task_id])
+                        return false;
+                    Event c;
+                    c.time = current_time;
+                    c.event_type = Event::EVENT_TASK_CANCELLED;
+                    c.task_id = action.task_id;
+                    c.resource_id = action.resource_id;
+                    c.slot = -1;
+                    pending_notifications.push(c);
+                    ++cancelled_attempts;
+                    return true;
+                }), pending_actions.end());
+                make_scheduler_actions(pending_actions);
+                pending_actions.clear();
+                if (!pending_notifications.empty())
+                    next_decision();
             }
         }
 
@@ -256,6 +668,16 @@ struct Simulator {
         }
         std::cerr << "time spent: " << finish_time << std::endl;
         std::cerr << "tasks completed: " << std::accumulate(completed.begin(), completed.end(), 0) << " / " << workflow.tasks.size() << std::endl;
+        // cost of scheduling decisions against the makespan they give
+        std::cerr << "scheduler cpu time: " << scheduler_time << " s in " << scheduler_calls << " calls" << std::endl;
+        if (with_latency())
+            std::cerr << "scheduler wall time: " << scheduler_wall_time << " s, busy time: " << scheduler_busy_time << std::endl;
+        if (backup_attempts > 0 || cancelled_attempts > 0)
+            std::cerr << "backup attempts: " << backup_attempts << ", cancelled: " << cancelled_attempts << std::endl;
+        if (checkpoints_written > 0 || checkpoint_restarts > 0)
+            std::cerr << "checkpoints: " << checkpoints_written << " written, " << checkpoint_restarts << " restarts from a checkpoint" << std::endl;
+        if (settings.scheduler_stats)
+            scheduler->print_stats();
     }
 
     int with_prob(double d) {
@@ -266,22 +688,50 @@ struct Simulator {
     std::vector<Resource> resources;
     Workflow workflow;
     std::shared_ptr<Scheduler> scheduler;
+    ExecutionModel exec_model;
     bool logging = true;
 
     std::priority_queue<Event, std::vector<Event>, std::greater<Event>> events;
     std::vector<bool> completed;
+    int completed_count = 0;
+    std::vector<int> remaining_predecessors;  // not completed predecessors of every task
+    std::vector<std::vector<int>> successors;
     std::vector<double> completion_time;
     std::vector<int> task_location;
     double current_time = 0;
+    double scheduler_time = 0;  // seconds of cpu time in init and notify
+    double scheduler_wall_time = 0;
+    double last_call_time = 0;  // cost of the last notify for the decision latency
+    long long scheduler_calls = 0;
+
+    // decision latency mode: events wait while the scheduler is busy, its actions wait for the decision to end
+    bool scheduler_busy = false;
+    double scheduler_busy_time = 0;  // simulated time spent in decisions
+    std::queue<Event> pending_notifications;
+    std::vector<Action> pending_actions;
+    std::vector<int> resource_downs;  // failures of every resource so far
+    std::vector<int> notified_downs;  // failures the scheduler already knows about
+    std::vector<int> down_sources;    // active down intervals of scripted failures, trace and failure model
 
     std::mt19937 rnd{123};
     std::normal_distribution<> nd{1, 0.1};
     std::uniform_real_distribution<> ud{0.0, 1.1};
     double fail_prob = 0.5;
 
-    std::set<int> failed_ids;
+    std::unordered_set<int> failed_ids;                       // attempts whose events are skipped
+    std::vector<std::set<std::pair<int, int>>> resource_tasks;  // event id and task of attempts on every resource
+    std::vector<std::vector<Attempt>> task_attempts;  // running attempts of every task
+    std::vector<double> progress;      // share of every task saved in its last checkpoint
+    long long backup_attempts = 0;     // tasks sent while already running
+    long long cancelled_attempts = 0;
+    long long checkpoints_written = 0;
+    long long checkpoint_restarts = 0;
     std::vector<std::vector<std::pair<double, double>>> resource_failures;
     std::vector<std::vector<std::tuple<double, double, double>>> resource_queues;
+    std::vector<FailureModel> failure_models;
+    double model_horizon = std::numeric_limits<double>::infinity();  // time after which failure models start no failure
+    TraceSource failure_trace;
+    TraceSource queue_trace;
 
     Settings settings{.optimize_transfers = true, .net_speed = 1.};
 };
@@ -6,6 +6,9 @@ struct Task {
 
     double weight;  // more -- slower
     int id;
+    int type = 0;  // row of workflow.type_speeds
+    double checkpoint_interval = 0;  // compute time between checkpoints, 0 without checkpoints
+    double checkpoint_cost = 0;      // time to write a checkpoint, and to read it on restart
 };
 
 #endif
@@ -0,0 +1,104 @@
+#ifndef SIMULATOR_THREAD_POOL_HPP_
+#define SIMULATOR_THREAD_POOL_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// fixed set of worker threads for data-parallel loops. chunks of a loop are taken from a shared
+// counter by whichever worker is idle, so slow chunks don't hold the others back
+struct ThreadPool {
+    explicit ThreadPool(int threads = std::thread::hardware_concurrency()) {
+        threads = std::max(1, threads);
+        for (int i = 1; i < threads; ++i)
+            workers.emplace_back([this, i] { work(i); });
+    }
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator = (const ThreadPool &) = delete;
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+        }
+        start_cv.notify_all();
+        for (auto &worker : workers)
+            worker.join();
+    }
+
+    // number of workers including the calling thread
+    int size() const {
+        return workers.size() + 1;
+    }
+
+    // calls f(begin, end, worker) for chunks of [0, n), worker is in [0, size()), 0 is the calling thread
+    void parallel_for(int n, int chunk, const std::function<void(int, int, int)> &f) {
+        if (n <= chunk || workers.empty()) {
+            if (n > 0)
+                f(0, n, 0);
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            job = &f;
+            job_size = n;
+            job_chunk = chunk;
+            next_chunk = 0;
+            busy = workers.size();
+            ++generation;
+        }
+        start_cv.notify_all();
+        run_chunks(0);
+        std::unique_lock<std::mutex> lock(mutex);
+        done_cv.wait(lock, [this] { return busy == 0; });
+        job = nullptr;
+    }
+
+    void run_chunks(int worker) {
+        while (true) {
+            int begin = next_chunk.fetch_add(job_chunk);
+            if (begin >= job_size)
+                break;
+            (*job)(begin, std::min(job_size, begin + job_chunk), worker);
+        }
+    }
+
+    void work(int worker) {
+        long long seen = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                start_cv.wait(lock, [&] { return stop || generation != seen; });
+                if (stop)
+                    return;
+                seen = generation;
+            }
+            run_chunks(worker);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                --busy;
+            }
+            done_cv.notify_one();
+        }
+    }
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable start_cv;
+    std::condition_variable done_cv;
+    bool stop = false;
+    long long generation = 0;
+    int busy = 0;
+
+    const std::function<void(int, int, int)> *job = nullptr;
+    int job_size = 0;
+    int job_chunk = 1;
+    std::atomic<int> next_chunk{0};
+};
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef SIMULATOR_TRACE_SOURCE_HPP_
+#define SIMULATOR_TRACE_SOURCE_HPP_
+
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+
+// reads intervals "resource start duration [factor]" line by line from a file sorted by start,
+// empty lines and lines starting with '#' are skipped
+struct TraceSource {
+    void open(const std::string &file, bool with_factor) {
+        in = std::make_shared<std::ifstream>(file);
+        if (!*in) {
+            std::cerr << "can't open trace " << file << std::endl;
+            exit(1);
+        }
+        this->file = file;
+        this->with_factor = with_factor;
+    }
+
+    bool is_open() const {
+        return in != nullptr;
+    }
+
+    // reads the next interval, returns false at the end of the trace
+    bool next() {
+        if (!in)
+            return false;
+        std::string line;
+        while (std::getline(*in, line)) {
+            ++line_number;
+            if (line.empty() || line[0] == '#')
+                continue;
+            std::istringstream ss(line);
+            double prev_start = start;
+            double duration;
+            if (!(ss >> resource >> start >> duration) || (with_factor && !(ss >> factor))) {
+                std::cerr << "wrong line " << line_number << " in trace " << file << std::endl;
+                exit(1);
+            }
+            if (start < prev_start) {
+                std::cerr << "trace " << file << " is not sorted by start time at line " << line_number << std::endl;
+                exit(1);
+            }
+            end = start + duration;
+            return true;
+        }
+        in.reset();
+        return false;
+    }
+
+    std::shared_ptr<std::istream> in;
+    std::string file;
+    bool with_factor = false;
+    int line_number = 0;
+
+    int resource = -1;
+    double start = 0;
+    double end = 0;
+    double factor = 1;
+};
+
+#endif
@@ -44,6 +44,26 @@ struct Workflow {
                 }
             }
         }
+        if (!type_speeds.empty()) {
+            for (const auto &row : type_speeds) {
+                if (row.size() != type_speeds[0].size()) {
+                    std::cerr << "all rows of type_speeds should have the same size" << std::endl;
+                    exit(1);
+                }
+                for (double speed : row) {
+                    if (!(speed > 0)) {
+                        std::cerr << "wrong type speed " << speed << ", should be positive" << std::endl;
+                        exit(1);
+                    }
+                }
+            }
+            for (const auto &task : tasks) {
+                if (task.type < 0 || task.type >= (int)type_speeds.size()) {
+                    std::cerr << "wrong task type " << task.type << std::endl;
+                    exit(1);
+                }
+            }
+        }
 
         // check that graph is acyclic
         {
@@ -78,6 +98,8 @@ struct Workflow {
     std::vector<Task> tasks;
     // dependency_graph[i] contains [j, w] iff j must be completed before start of i, and there is w data from j to i
     std::vector<std::vector<std::pair<int, int>>> dependency_graph;
+    // type_speeds[i][j] is the speed of a task with type i on a resource with type j, replaces Resource::speed if not empty
+    std::vector<std::vector<double>> type_speeds;
 };
 
 Workflow get_romboid_workflow() {